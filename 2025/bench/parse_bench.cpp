@@ -0,0 +1,149 @@
+// Microbenchmark for common/parse.hpp against the std::sto* calls the solvers
+// used to make. Every day's real input is scanned the way that day reads it,
+// once per parser, and the per-number cost is reported.
+//
+// Usage: ./parse_bench [repeats]   (run from 2025/bench)
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/input_reader.hpp"
+#include "common/parse.hpp"
+
+struct InputFormat
+{
+    const char *name;
+    const char *path;
+    const char *example;
+};
+
+static const InputFormat FORMATS[] = {
+    {"day_01", "../day_01/input/input.txt", "L68"},
+    {"day_02", "../day_02/input/input.txt", "11-22,95-115"},
+    {"day_05", "../day_05/input/input.txt", "3-5 / 17"},
+    {"day_06", "../day_06/input/input.txt", "123 328  51"},
+    {"day_08", "../day_08/input/input.txt", "162,817,812"},
+    {"day_09", "../day_09/input/input.txt", "7,1"},
+    {"day_10", "../day_10/input/input.txt", "(0,2,3) {3,5,4}"},
+};
+
+// The pre-parse.hpp way: copy each line into a std::string, then substr every
+// digit run and hand it to std::stoull
+uint64_t scanWithStoull(const std::string &text, size_t &count)
+{
+    uint64_t checksum = 0;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        size_t pos = 0;
+        while (pos < line.size())
+        {
+            if (!aoc::isDigit(line[pos]))
+            {
+                pos++;
+                continue;
+            }
+            size_t end = pos;
+            while (end < line.size() && aoc::isDigit(line[end]))
+                end++;
+            checksum += std::stoull(line.substr(pos, end - pos));
+            count++;
+            pos = end;
+        }
+    }
+    return checksum;
+}
+
+uint64_t scanWithFromChars(std::string_view text, size_t &count)
+{
+    uint64_t checksum = 0;
+    const char *cursor = text.data();
+    const char *end = text.data() + text.size();
+    while ((cursor = aoc::skipToNumber(cursor, end)) < end)
+    {
+        uint64_t value = 0;
+        cursor = std::from_chars(cursor, end, value).ptr;
+        checksum += value;
+        count++;
+    }
+    return checksum;
+}
+
+uint64_t scanWithAocParse(std::string_view text, size_t &count)
+{
+    uint64_t checksum = 0;
+    const char *cursor = text.data();
+    const char *end = text.data() + text.size();
+    while ((cursor = aoc::skipToNumber(cursor, end)) < end)
+    {
+        uint64_t value = 0;
+        cursor = aoc::parseUnsigned(cursor, end, value);
+        checksum += value;
+        count++;
+    }
+    return checksum;
+}
+
+template <typename Scanner>
+double measureNsPerNumber(Scanner &&scanner, int repeats, uint64_t &checksum)
+{
+    size_t count = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r)
+    {
+        checksum = scanner(count);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return count ? elapsed / count : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+    int repeats = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    std::cout << std::left << std::setw(8) << "input" << std::setw(20) << "format"
+              << std::right << std::setw(15) << "stoull ns/num" << std::setw(19) << "from_chars ns/num"
+              << std::setw(12) << "aoc ns/num" << std::setw(10) << "speedup" << std::endl;
+
+    for (const auto &format : FORMATS)
+    {
+        aoc::InputFile file(format.path);
+        if (!file.isOpen())
+        {
+            std::cerr << "Error: Could not open file " << format.path << std::endl;
+            continue;
+        }
+
+        std::string_view text = file.contents();
+        std::string textCopy(text);
+
+        uint64_t stdChecksum = 0, fromCharsChecksum = 0, aocChecksum = 0;
+        double stdNs = measureNsPerNumber([&](size_t &count)
+                                          { return scanWithStoull(textCopy, count); }, repeats, stdChecksum);
+        double fromCharsNs = measureNsPerNumber([&](size_t &count)
+                                                { return scanWithFromChars(text, count); }, repeats, fromCharsChecksum);
+        double aocNs = measureNsPerNumber([&](size_t &count)
+                                          { return scanWithAocParse(text, count); }, repeats, aocChecksum);
+
+        if (stdChecksum != aocChecksum || fromCharsChecksum != aocChecksum)
+        {
+            std::cerr << "Error: checksum mismatch for " << format.name << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(8) << format.name << std::setw(20) << format.example
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(15) << stdNs << std::setw(19) << fromCharsNs << std::setw(12) << aocNs
+                  << std::setw(9) << (aocNs > 0 ? stdNs / aocNs : 0.0) << "x" << std::endl;
+    }
+    return 0;
+}
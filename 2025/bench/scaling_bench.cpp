@@ -0,0 +1,429 @@
+// Scaling sweep: runs each day's solvers on generated inputs of growing size
+// and fits how time grows with input size.
+//
+//   ./scaling_bench [--day N]... [--part 1|2|both] [--budget SECONDS]
+//                   [--min-scale X] [--max-scale X] [--growth G] [--repeat R]
+//                   [--seed S] [--csv PATH] [--json PATH]
+//
+// Sizes start at --min-scale times the shipped input volume (default 1) and
+// grow by --growth (default 2) until the next step would not fit in the
+// per-part time --budget (default 10 s) or --max-scale is reached. Every size
+// runs in a forked child so its peak RSS can be read from wait4(). Each
+// (day, part) gets an empirical exponent (slope of log time over log n) and
+// the closest of n, n log n, n^2, n^2 log n and n^3, where n counts input
+// elements (grid days count cells).
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common/solver.hpp"
+#include "common/stats.hpp"
+#include "runner/days.hpp"
+#include "tools/generators.hpp"
+
+namespace
+{
+
+struct Options
+{
+    std::vector<int> days;
+    std::vector<int> parts = {1, 2};
+    double budgetSeconds = 10.0;
+    double minScale = 1.0;
+    double maxScale = 10000.0;
+    double growth = 2.0;
+    int repeat = 3;
+    uint64_t seed = 1;
+    std::string csvPath;
+    std::string jsonPath;
+};
+
+struct Measurement
+{
+    double scale = 0.0;
+    size_t size = 0;
+    double elements = 0.0;
+    size_t inputBytes = 0;
+    double parseSeconds = 0.0;
+    double solveSeconds = 0.0;
+    double totalSeconds = 0.0;
+    long peakRssKb = 0;
+    aoc::Answer answer = 0;
+};
+
+// Result the child sends back through the pipe
+struct ChildResult
+{
+    size_t inputBytes;
+    double parseSeconds;
+    double solveSeconds;
+    double totalSeconds;
+    aoc::Answer answer;
+};
+
+struct ComplexityClass
+{
+    const char *name;
+    double (*cost)(double n);
+};
+
+const ComplexityClass CLASSES[] = {
+    {"n", [](double n)
+     { return n; }},
+    {"n log n", [](double n)
+     { return n * std::log2(std::max(n, 2.0)); }},
+    {"n^2", [](double n)
+     { return n * n; }},
+    {"n^2 log n", [](double n)
+     { return n * n * std::log2(std::max(n, 2.0)); }},
+    {"n^3", [](double n)
+     { return n * n * n; }},
+};
+
+struct SweepResult
+{
+    int day;
+    int part;
+    std::vector<Measurement> measurements;
+    bool hitBudget = false;
+    double exponent = 0.0;
+    const char *bestClass = "-";
+};
+
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--day N]... [--part 1|2|both] [--budget SECONDS] [--min-scale X]"
+              << " [--max-scale X] [--growth G] [--repeat R] [--seed S] [--csv PATH] [--json PATH]" << std::endl;
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage(argv[0]);
+            std::exit(0);
+        }
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Error: " << arg << " needs a value" << std::endl;
+            return false;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "--day")
+            options.days.push_back(std::atoi(value.c_str()));
+        else if (arg == "--part")
+            options.parts = value == "both" ? std::vector<int>{1, 2} : std::vector<int>{std::atoi(value.c_str())};
+        else if (arg == "--budget")
+            options.budgetSeconds = std::atof(value.c_str());
+        else if (arg == "--min-scale")
+            options.minScale = std::atof(value.c_str());
+        else if (arg == "--max-scale")
+            options.maxScale = std::atof(value.c_str());
+        else if (arg == "--growth")
+            options.growth = std::max(1.1, std::atof(value.c_str()));
+        else if (arg == "--repeat")
+            options.repeat = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--seed")
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--csv")
+            options.csvPath = value;
+        else if (arg == "--json")
+            options.jsonPath = value;
+        else
+        {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.days.empty())
+    {
+        for (const auto &entry : aoc::DAYS)
+            options.days.push_back(entry.day);
+    }
+    return true;
+}
+
+[[noreturn]] void runChild(int writeFd, const aoc::DayEntry &entry, const aoc::gen::Generator &generator,
+                           int part, size_t size, uint64_t seed, int repeat)
+{
+    std::string input = aoc::gen::generateText(generator, size, seed);
+
+    ChildResult result{input.size(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::max(), 0};
+    for (int r = 0; r < repeat; ++r)
+    {
+        aoc::PhaseRecorder phases;
+        result.answer = entry.solve(input, part, phases);
+        result.parseSeconds = std::min(result.parseSeconds, phases.nanoseconds(aoc::Phase::PARSE) / 1e9);
+        result.solveSeconds = std::min(result.solveSeconds, phases.nanoseconds(aoc::Phase::SOLVE) / 1e9);
+        result.totalSeconds = std::min(result.totalSeconds, phases.totalNanoseconds() / 1e9);
+    }
+
+    ssize_t written = ::write(writeFd, &result, sizeof(result));
+    ::_exit(written == static_cast<ssize_t>(sizeof(result)) ? 0 : 1);
+}
+
+// Runs one size in a child process. Returns false when the child did not
+// report back within timeoutSeconds (it is killed) or failed.
+bool measure(const aoc::DayEntry &entry, const aoc::gen::Generator &generator, int part, size_t size,
+             const Options &options, double timeoutSeconds, Measurement &measurement)
+{
+    int fds[2];
+    if (::pipe(fds) != 0)
+        return false;
+
+    std::cout.flush();
+    pid_t child = ::fork();
+    if (child < 0)
+        return false;
+    if (child == 0)
+    {
+        ::close(fds[0]);
+        runChild(fds[1], entry, generator, part, size, options.seed, options.repeat);
+    }
+    ::close(fds[1]);
+
+    ChildResult result{};
+    bool received = false;
+    pollfd waitFor{fds[0], POLLIN, 0};
+    int timeoutMs = static_cast<int>(std::min(timeoutSeconds * 1000.0, double(std::numeric_limits<int>::max())));
+    if (::poll(&waitFor, 1, std::max(timeoutMs, 1)) > 0)
+        received = ::read(fds[0], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+    ::close(fds[0]);
+
+    if (!received)
+        ::kill(child, SIGKILL);
+
+    int status = 0;
+    rusage usage{};
+    ::wait4(child, &status, 0, &usage);
+    if (!received)
+        return false;
+
+    measurement.size = size;
+    measurement.elements = generator.squareGrid ? double(size) * double(size) : double(size);
+    measurement.inputBytes = result.inputBytes;
+    measurement.parseSeconds = result.parseSeconds;
+    measurement.solveSeconds = result.solveSeconds;
+    measurement.totalSeconds = result.totalSeconds;
+    measurement.peakRssKb = usage.ru_maxrss;
+    measurement.answer = result.answer;
+    return true;
+}
+
+void fitComplexity(SweepResult &sweep)
+{
+    std::vector<double> logN, logTime;
+    for (const auto &m : sweep.measurements)
+    {
+        // Sub-microsecond points are timer noise, not scaling
+        if (m.totalSeconds < 1e-6)
+            continue;
+        logN.push_back(std::log(m.elements));
+        logTime.push_back(std::log(m.totalSeconds));
+    }
+    if (logN.size() < 2)
+        return;
+
+    sweep.exponent = aoc::fitLine(logN, logTime).slope;
+
+    // The best class is the one whose time/cost ratio stays the most constant
+    double bestSpread = std::numeric_limits<double>::max();
+    for (const auto &complexity : CLASSES)
+    {
+        std::vector<double> ratios;
+        for (const auto &m : sweep.measurements)
+        {
+            if (m.totalSeconds >= 1e-6)
+                ratios.push_back(std::log(m.totalSeconds) - std::log(complexity.cost(m.elements)));
+        }
+        double mean = 0.0;
+        for (double ratio : ratios)
+            mean += ratio;
+        mean /= ratios.size();
+        double spread = 0.0;
+        for (double ratio : ratios)
+            spread += (ratio - mean) * (ratio - mean);
+
+        if (spread < bestSpread)
+        {
+            bestSpread = spread;
+            sweep.bestClass = complexity.name;
+        }
+    }
+}
+
+SweepResult sweep(const aoc::DayEntry &entry, const aoc::gen::Generator &generator, int part, const Options &options)
+{
+    SweepResult result{entry.day, part, {}, false, 0.0, "-"};
+    double spent = 0.0;
+    size_t previousSize = 0;
+
+    for (double scale = options.minScale; scale <= options.maxScale * 1.0001; scale *= options.growth)
+    {
+        size_t size = aoc::gen::sizeForScale(generator, scale);
+        if (size == previousSize)
+            continue;
+        previousSize = size;
+
+        double remaining = options.budgetSeconds - spent;
+        if (remaining <= 0.0)
+        {
+            result.hitBudget = true;
+            break;
+        }
+
+        // Skip sizes that are predicted not to fit, using the fit so far
+        if (!result.measurements.empty())
+        {
+            const auto &last = result.measurements.back();
+            double exponent = std::max(1.0, result.measurements.size() >= 2 ? result.exponent : 1.0);
+            double elements = generator.squareGrid ? double(size) * double(size) : double(size);
+            double predicted = last.totalSeconds * options.repeat * std::pow(elements / last.elements, exponent);
+            if (predicted > remaining)
+            {
+                result.hitBudget = true;
+                break;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        Measurement measurement;
+        bool completed = measure(entry, generator, part, size, options, remaining, measurement);
+        spent += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!completed)
+        {
+            result.hitBudget = true;
+            break;
+        }
+
+        measurement.scale = scale;
+        result.measurements.push_back(measurement);
+        fitComplexity(result);
+
+        std::cout << "  day " << entry.day << " part " << part << " scale " << scale << " size " << size
+                  << ": " << std::fixed << std::setprecision(6) << measurement.totalSeconds << " s, "
+                  << measurement.peakRssKb << " KB peak RSS" << std::defaultfloat << std::endl;
+    }
+    return result;
+}
+
+void writeCsv(std::ostream &out, const std::vector<SweepResult> &results)
+{
+    out << "day,part,scale,size,elements,input_bytes,parse_s,solve_s,total_s,peak_rss_kb,answer\n";
+    for (const auto &result : results)
+    {
+        for (const auto &m : result.measurements)
+        {
+            out << result.day << "," << result.part << "," << m.scale << "," << m.size << "," << m.elements << ","
+                << m.inputBytes << "," << m.parseSeconds << "," << m.solveSeconds << "," << m.totalSeconds << ","
+                << m.peakRssKb << "," << m.answer << "\n";
+        }
+    }
+}
+
+void writeJson(std::ostream &out, const std::vector<SweepResult> &results)
+{
+    out << "{\n  \"sweeps\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &result = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"day\": " << result.day << ", \"part\": " << result.part
+            << ", \"exponent\": " << result.exponent << ", \"class\": \"" << result.bestClass
+            << "\", \"hit_budget\": " << (result.hitBudget ? "true" : "false") << ", \"points\": [";
+        for (size_t j = 0; j < result.measurements.size(); ++j)
+        {
+            const auto &m = result.measurements[j];
+            out << (j ? ", " : "") << "{\"scale\": " << m.scale << ", \"size\": " << m.size << ", \"elements\": " << m.elements
+                << ", \"input_bytes\": " << m.inputBytes << ", \"parse_s\": " << m.parseSeconds
+                << ", \"solve_s\": " << m.solveSeconds << ", \"total_s\": " << m.totalSeconds
+                << ", \"peak_rss_kb\": " << m.peakRssKb << "}";
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}" << std::endl;
+}
+
+template <typename Writer>
+bool writeFile(const std::string &path, Writer &&writer)
+{
+    if (path.empty())
+        return true;
+
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not open file " << path << std::endl;
+        return false;
+    }
+    writer(file);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::vector<SweepResult> results;
+    for (int day : options.days)
+    {
+        const aoc::DayEntry *entry = aoc::findDay(day);
+        const aoc::gen::Generator *generator = aoc::gen::findGenerator(day);
+        if (entry == nullptr || generator == nullptr)
+        {
+            std::cerr << "Error: no solver or generator for day " << day << std::endl;
+            return 2;
+        }
+
+        for (int part : options.parts)
+        {
+            results.push_back(sweep(*entry, *generator, part, options));
+        }
+    }
+
+    std::cout << std::endl
+              << std::left << std::setw(5) << "day" << std::setw(6) << "part" << std::setw(8) << "points"
+              << std::setw(12) << "max size" << std::setw(10) << "exponent" << "class" << std::endl;
+    for (const auto &result : results)
+    {
+        std::cout << std::left << std::setw(5) << result.day << std::setw(6) << result.part
+                  << std::setw(8) << result.measurements.size()
+                  << std::setw(12) << (result.measurements.empty() ? 0 : result.measurements.back().size)
+                  << std::setw(10) << std::fixed << std::setprecision(2) << result.exponent << std::defaultfloat
+                  << result.bestClass << (result.hitBudget ? "  (stopped at time budget)" : "") << std::endl;
+    }
+
+    if (!writeFile(options.csvPath, [&](std::ostream &out)
+                   { writeCsv(out, results); }) ||
+        !writeFile(options.jsonPath, [&](std::ostream &out)
+                   { writeJson(out, results); }))
+        return 1;
+    return 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#include "common/alloc_tracker.hpp"
+
+// Replacement global operator new/delete feeding aoc::alloc. Include this in
+// exactly one translation unit of a program; see common/alloc_tracker.hpp.
+
+namespace
+{
+[[maybe_unused]] const bool hooksRegistered = (aoc::alloc::detail::hooksInstalled = true);
+} // namespace
+
+void *operator new(size_t size) { return aoc::alloc::detail::allocateOrThrow(size, 0U); }
+void *operator new[](size_t size) { return aoc::alloc::detail::allocateOrThrow(size, 0U); }
+void *operator new(size_t size, std::align_val_t alignment) { return aoc::alloc::detail::allocateOrThrow(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment) { return aoc::alloc::detail::allocateOrThrow(size, static_cast<size_t>(alignment)); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return aoc::alloc::detail::allocate(size, 0U); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return aoc::alloc::detail::allocate(size, 0U); }
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return aoc::alloc::detail::allocate(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return aoc::alloc::detail::allocate(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void *pointer) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete[](void *pointer) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete(void *pointer, size_t) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { aoc::alloc::detail::release(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { aoc::alloc::detail::release(pointer); }
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h>
+
+// Heap accounting for solver phases. Counting needs the global operator new
+// and delete replaced, which may only happen in one translation unit of a
+// program: include common/alloc_hooks.hpp there (the aoc runner does). Even with the hooks linked in nothing is counted
+// until aoc::alloc::enable(true), so an uninstrumented run pays one relaxed
+// load per allocation.
+//
+// Counters are process wide. Live bytes are measured with malloc_usable_size
+// so that allocation and release always agree, whichever delete overload the
+// compiler picked.
+
+namespace aoc
+{
+
+struct AllocationStats
+{
+    uint64_t allocations = 0U; // calls to operator new
+    uint64_t bytes = 0U;       // bytes requested
+    uint64_t peakBytes = 0U;   // peak live bytes above the level at scope start
+
+    AllocationStats &operator+=(const AllocationStats &other)
+    {
+        allocations += other.allocations;
+        bytes += other.bytes;
+        peakBytes = peakBytes > other.peakBytes ? peakBytes : other.peakBytes;
+        return *this;
+    }
+};
+
+namespace alloc
+{
+namespace detail
+{
+
+inline std::atomic<bool> hooksInstalled = false;
+inline std::atomic<bool> enabled = false;
+inline std::atomic<uint64_t> allocations = 0U;
+inline std::atomic<uint64_t> bytes = 0U;
+inline std::atomic<int64_t> liveBytes = 0;
+inline std::atomic<int64_t> peakBytes = 0;
+
+inline void recordAllocation(void *pointer, size_t size)
+{
+    if (pointer == nullptr || !enabled.load(std::memory_order_relaxed))
+        return;
+
+    allocations.fetch_add(1U, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    int64_t usable = static_cast<int64_t>(malloc_usable_size(pointer));
+    int64_t live = liveBytes.fetch_add(usable, std::memory_order_relaxed) + usable;
+    int64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+inline void recordRelease(void *pointer)
+{
+    // Memory allocated before tracking was enabled drives the live count
+    // below the starting level; only differences are ever reported.
+    if (pointer != nullptr && enabled.load(std::memory_order_relaxed))
+        liveBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(pointer)), std::memory_order_relaxed);
+}
+
+inline void *allocate(size_t size, size_t alignment)
+{
+    if (size == 0U)
+        size = 1U;
+
+    void *pointer = nullptr;
+    if (alignment <= alignof(std::max_align_t))
+        pointer = std::malloc(size);
+    else if (posix_memalign(&pointer, alignment, size) != 0)
+        pointer = nullptr;
+
+    recordAllocation(pointer, size);
+    return pointer;
+}
+
+inline void *allocateOrThrow(size_t size, size_t alignment)
+{
+    void *pointer = allocate(size, alignment);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+inline void release(void *pointer)
+{
+    recordRelease(pointer);
+    std::free(pointer);
+}
+
+} // namespace detail
+
+// True when this program replaced operator new/delete with the counting ones
+inline bool installed()
+{
+    return detail::hooksInstalled.load(std::memory_order_relaxed);
+}
+
+inline void enable(bool on)
+{
+    detail::enabled.store(on && installed(), std::memory_order_relaxed);
+}
+
+inline bool enabled()
+{
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+// Opaque position in the allocation stream, taken at the start of a scope
+struct Mark
+{
+    uint64_t allocations;
+    uint64_t bytes;
+    int64_t liveBytes;
+};
+
+// Starts a scope: remembers the counters and restarts peak tracking from the
+// current live level. Nested scopes therefore see the outer peak restart.
+inline Mark mark()
+{
+    int64_t live = detail::liveBytes.load(std::memory_order_relaxed);
+    detail::peakBytes.store(live, std::memory_order_relaxed);
+    return {detail::allocations.load(std::memory_order_relaxed), detail::bytes.load(std::memory_order_relaxed), live};
+}
+
+inline AllocationStats since(const Mark &start)
+{
+    AllocationStats stats;
+    stats.allocations = detail::allocations.load(std::memory_order_relaxed) - start.allocations;
+    stats.bytes = detail::bytes.load(std::memory_order_relaxed) - start.bytes;
+    int64_t peak = detail::peakBytes.load(std::memory_order_relaxed) - start.liveBytes;
+    stats.peakBytes = peak > 0 ? static_cast<uint64_t>(peak) : 0U;
+    return stats;
+}
+
+} // namespace alloc
+} // namespace aoc
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+
+#include "common/huge_pages.hpp"
+
+// Monotonic arena for the structures a day builds from its input. Parsers
+// take a std::pmr::memory_resource and build std::pmr containers into it, so
+// the many small vectors and tree nodes of a parse come out of a few large
+// blocks instead of one heap allocation each; freeing is a no-op per object
+// and the blocks go back in one go when the arena is destroyed.
+//
+//   aoc::Arena arena(input);
+//   auto data = parseInput(input, arena.resource());
+//
+// Anything built into an arena must not outlive it. Parsers default to the
+// global heap resource, so standalone callers need not create one. Arena
+// blocks come from largeTableResource(), so with huge pages on the large
+// blocks of a big input are huge-page backed (see common/huge_pages.hpp).
+
+namespace aoc
+{
+
+class Arena
+{
+public:
+    // First block size per input byte; the arena grows geometrically past it
+    static constexpr size_t BYTES_PER_INPUT_BYTE = 4U;
+    static constexpr size_t MIN_BLOCK_BYTES = 4096U;
+
+    explicit Arena(size_t initialBytes = MIN_BLOCK_BYTES)
+        : resource_(std::max(initialBytes, MIN_BLOCK_BYTES), largeTableResource())
+    {
+    }
+
+    // Sized for the structures parsed out of `input`
+    explicit Arena(std::string_view input) : Arena(input.size() * BYTES_PER_INPUT_BYTE)
+    {
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    std::pmr::memory_resource *resource() { return &resource_; }
+
+    // Returns every block at once. Containers still using the arena dangle.
+    void release() { resource_.release(); }
+
+private:
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+} // namespace aoc
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "common/hash.hpp"
+#include "common/input_reader.hpp"
+
+// Pre-parsed binary form of a day's input, so repeated runs skip text parsing.
+//
+// A cache file is a header, a table of columns and the column data, every
+// column starting on a 64-byte boundary:
+//
+//   CacheHeader   magic, format version, day, XXH64 of the input text
+//   ColumnEntry   element size, element count and file offset, per column
+//   data          each column a plain array of fixed-size elements
+//
+// Days decide what their columns are (one column per struct field, bit-packed
+// grids as 64-bit words) and write them with CacheWriter. CacheFile maps the
+// file read-only and hands columns out as spans straight into the mapping, so
+// loading is a validation of the header plus whatever copy the day's own
+// structures need. A cache written for other input bytes, another day or
+// another format version is simply not opened.
+
+namespace aoc
+{
+
+// Also bumped when a day changes its columns, so old caches are rewritten
+// (2: day 04 stores its grid's padded rows)
+constexpr uint32_t CACHE_FORMAT_VERSION = 2U;
+
+struct CacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t day;
+    uint64_t inputHash;
+    uint32_t columnCount;
+    uint32_t reserved;
+};
+
+struct ColumnEntry
+{
+    uint32_t elementSize;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t offset;
+};
+
+namespace detail
+{
+
+constexpr char CACHE_MAGIC[8] = {'A', 'O', 'C', 'C', 'A', 'C', 'H', 'E'};
+constexpr size_t COLUMN_ALIGNMENT = 64U;
+
+inline size_t alignColumn(size_t offset)
+{
+    return (offset + COLUMN_ALIGNMENT - 1U) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT;
+}
+
+} // namespace detail
+
+// Where the cache for an input lives: next to it, named after its hash
+struct CacheLocation
+{
+    std::string path;
+    uint64_t inputHash;
+};
+
+inline CacheLocation locateCache(const std::string &inputPath, std::string_view input)
+{
+    uint64_t inputHash = xxh64(input);
+    return {inputPath + "." + hashToHex(inputHash) + ".cache", inputHash};
+}
+
+class CacheWriter
+{
+public:
+    CacheWriter(int day, uint64_t inputHash) : day_(day), inputHash_(inputHash) {}
+
+    // Appends a column holding every element of `values`, converted to T
+    template <typename T, typename Range>
+    void addColumn(const Range &values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "cache columns hold plain values");
+        Column column{sizeof(T), 0U, {}};
+        for (const auto &value : values)
+        {
+            T element = static_cast<T>(value);
+            const char *bytes = reinterpret_cast<const char *>(&element);
+            column.data.insert(column.data.end(), bytes, bytes + sizeof(T));
+            ++column.count;
+        }
+        columns_.push_back(std::move(column));
+    }
+
+    // Writes to a temporary file and renames it into place, so a reader never
+    // sees a half-written cache
+    bool write(const std::string &path) const
+    {
+        CacheHeader header{};
+        std::memcpy(header.magic, detail::CACHE_MAGIC, sizeof(header.magic));
+        header.version = CACHE_FORMAT_VERSION;
+        header.day = static_cast<uint32_t>(day_);
+        header.inputHash = inputHash_;
+        header.columnCount = static_cast<uint32_t>(columns_.size());
+
+        std::vector<ColumnEntry> entries;
+        size_t offset = detail::alignColumn(sizeof(CacheHeader) + columns_.size() * sizeof(ColumnEntry));
+        for (const auto &column : columns_)
+        {
+            entries.push_back({column.elementSize, 0U, column.count, offset});
+            offset = detail::alignColumn(offset + column.data.size());
+        }
+
+        std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(ColumnEntry));
+            for (size_t i = 0; i < columns_.size(); ++i)
+            {
+                pad(out, entries[i].offset);
+                out.write(columns_[i].data.data(), columns_[i].data.size());
+            }
+            if (!out)
+                return false;
+        }
+        return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+    }
+
+private:
+    struct Column
+    {
+        uint32_t elementSize;
+        uint64_t count;
+        std::vector<char> data;
+    };
+
+    static void pad(std::ofstream &out, uint64_t offset)
+    {
+        static constexpr char ZEROS[detail::COLUMN_ALIGNMENT] = {};
+        uint64_t position = static_cast<uint64_t>(out.tellp());
+        if (position < offset)
+            out.write(ZEROS, offset - position);
+    }
+
+    int day_;
+    uint64_t inputHash_;
+    std::vector<Column> columns_;
+};
+
+class CacheFile
+{
+public:
+    // Maps `path` and checks it is a cache of this format for `day` built from
+    // input with `inputHash`; isOpen() is false otherwise
+    CacheFile(const std::string &path, int day, uint64_t inputHash) : file_(path)
+    {
+        std::string_view bytes = file_.contents();
+        if (!file_.isOpen() || bytes.size() < sizeof(CacheHeader))
+            return;
+
+        const auto *header = reinterpret_cast<const CacheHeader *>(bytes.data());
+        if (std::memcmp(header->magic, detail::CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != CACHE_FORMAT_VERSION || header->day != static_cast<uint32_t>(day) ||
+            header->inputHash != inputHash ||
+            bytes.size() < sizeof(CacheHeader) + header->columnCount * sizeof(ColumnEntry))
+            return;
+
+        entries_ = {reinterpret_cast<const ColumnEntry *>(bytes.data() + sizeof(CacheHeader)), header->columnCount};
+        for (const auto &entry : entries_)
+        {
+            if (entry.offset > bytes.size() || entry.count * entry.elementSize > bytes.size() - entry.offset)
+                return;
+        }
+        valid_ = true;
+    }
+
+    bool isOpen() const { return valid_; }
+
+    size_t columnCount() const { return entries_.size(); }
+
+    size_t sizeBytes() const { return file_.contents().size(); }
+
+    // Column `index` as T values, or an empty span if it holds something else
+    template <typename T>
+    std::span<const T> column(size_t index) const
+    {
+        if (!valid_ || index >= entries_.size() || entries_[index].elementSize != sizeof(T))
+            return {};
+
+        const char *start = file_.contents().data() + entries_[index].offset;
+        if (reinterpret_cast<uintptr_t>(start) % alignof(T) != 0U)
+            return {};
+        return {reinterpret_cast<const T *>(start), static_cast<size_t>(entries_[index].count)};
+    }
+
+private:
+    InputFile file_;
+    std::span<const ColumnEntry> entries_;
+    bool valid_ = false;
+};
+
+} // namespace aoc
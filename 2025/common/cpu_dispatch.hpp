@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+// Runtime ISA dispatch for the hot kernels. The build targets plain x86-64
+// (SSE2), so code that should use wider units is compiled a second time per
+// level with a target attribute and the variant to call is picked from cpuid
+// at run time:
+//
+//   AOC_TARGET_AVX2 void kernelAvx2(...) { kernelBody<32>(...); }
+//   ...
+//   aoc::cpu::select(kernelBaseline, kernelSse42, kernelAvx2, kernelAvx512)(...);
+//
+// Kernel bodies are always-inline templates over the vector width written
+// with GCC vector extensions, so each wrapper gets the body vectorized for
+// its own level. The level in use is the highest one the CPU supports unless
+// it is capped with forceIsa() (aoc --isa) or AOC_ISA=baseline|sse4.2|avx2|
+// avx512, which is how the variants are benchmarked against each other on
+// one machine. Forcing a level above what the CPU has is ignored.
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AOC_DISPATCH_X86 1
+#define AOC_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define AOC_TARGET_AVX2 __attribute__((target("avx2")))
+#define AOC_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl")))
+#else
+#define AOC_TARGET_SSE42
+#define AOC_TARGET_AVX2
+#define AOC_TARGET_AVX512
+#endif
+
+#define AOC_ALWAYS_INLINE __attribute__((always_inline)) inline
+
+namespace aoc::cpu
+{
+
+enum class IsaLevel : uint8_t
+{
+    BASELINE, // SSE2, what every x86-64 has
+    SSE42,
+    AVX2,
+    AVX512, // F + BW + VL
+};
+
+constexpr const char *isaName(IsaLevel level)
+{
+    switch (level)
+    {
+    case IsaLevel::BASELINE:
+        return "baseline";
+    case IsaLevel::SSE42:
+        return "sse4.2";
+    case IsaLevel::AVX2:
+        return "avx2";
+    case IsaLevel::AVX512:
+        return "avx512";
+    default:
+        return "unknown";
+    }
+}
+
+inline bool parseIsaLevel(std::string_view name, IsaLevel &level)
+{
+    for (auto candidate : {IsaLevel::BASELINE, IsaLevel::SSE42, IsaLevel::AVX2, IsaLevel::AVX512})
+    {
+        if (name == isaName(candidate))
+        {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Highest level the CPU (and OS, for the AVX state) supports
+inline IsaLevel detectedIsa()
+{
+    static const IsaLevel detected = []
+    {
+#ifdef AOC_DISPATCH_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl"))
+            return IsaLevel::AVX512;
+        if (__builtin_cpu_supports("avx2"))
+            return IsaLevel::AVX2;
+        if (__builtin_cpu_supports("sse4.2"))
+            return IsaLevel::SSE42;
+#endif
+        return IsaLevel::BASELINE;
+    }();
+    return detected;
+}
+
+namespace detail
+{
+
+inline std::atomic<IsaLevel> &activeLevel()
+{
+    static std::atomic<IsaLevel> level = []
+    {
+        IsaLevel requested = detectedIsa();
+        const char *name = std::getenv("AOC_ISA");
+        if (name != nullptr && parseIsaLevel(name, requested) && requested < detectedIsa())
+            return requested;
+        return detectedIsa();
+    }();
+    return level;
+}
+
+} // namespace detail
+
+// Level the kernels run at
+inline IsaLevel activeIsa()
+{
+    return detail::activeLevel().load(std::memory_order_relaxed);
+}
+
+// Caps the level the kernels run at; levels the CPU lacks fall back to the
+// detected one. Returns the level now in use.
+inline IsaLevel forceIsa(IsaLevel level)
+{
+    IsaLevel active = level < detectedIsa() ? level : detectedIsa();
+    detail::activeLevel().store(active, std::memory_order_relaxed);
+    return active;
+}
+
+inline bool supports(IsaLevel level)
+{
+    return activeIsa() >= level;
+}
+
+// The variant of a kernel for the active level
+template <typename Function>
+Function select(Function baseline, Function sse42, Function avx2, Function avx512)
+{
+    switch (activeIsa())
+    {
+    case IsaLevel::AVX512:
+        return avx512;
+    case IsaLevel::AVX2:
+        return avx2;
+    case IsaLevel::SSE42:
+        return sse42;
+    default:
+        return baseline;
+    }
+}
+
+// Width in bytes of the vectors a kernel body uses at each level
+constexpr size_t BASELINE_VECTOR_BYTES = 16U;
+constexpr size_t SSE42_VECTOR_BYTES = 16U;
+constexpr size_t AVX2_VECTOR_BYTES = 32U;
+constexpr size_t AVX512_VECTOR_BYTES = 64U;
+
+namespace detail
+{
+
+template <typename T, size_t BYTES>
+struct VectorOf
+{
+    typedef T Type __attribute__((vector_size(BYTES)));
+};
+
+} // namespace detail
+
+// GCC vector of T, BYTES wide. Declaring the vector type through a class
+// keeps it a vector inside templates, where a dependent vector_size typedef
+// in the function body is not reliably one.
+template <typename T, size_t BYTES>
+using Vector = typename detail::VectorOf<T, BYTES>::Type;
+
+} // namespace aoc::cpu
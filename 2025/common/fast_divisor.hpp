@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+// Division of 32-bit unsigned values by a divisor known only at run time,
+// without a divide instruction. The constructor precomputes M = ceil(2^64 / d)
+// once; afterwards
+//
+//   n / d = high 64 bits of M * n
+//   n % d = high 64 bits of (low 64 bits of M * n) * d
+//
+// which is exact for every 32-bit n and every d >= 2 (Lemire, Kaser and Kurz,
+// "Faster Remainder by Direct Computation", 2019). For d = 1, M wraps to 0,
+// which still gives the remainder and is special-cased for the quotient. A
+// divisor known at compile time needs none of this: the compiler
+// strength-reduces it already.
+
+namespace aoc
+{
+
+class FastDivisor
+{
+public:
+    explicit FastDivisor(uint32_t divisor) : divisor_(divisor), multiplier_(UINT64_MAX / divisor + 1U) {}
+
+    uint32_t divisor() const { return divisor_; }
+
+    uint32_t divide(uint32_t value) const
+    {
+        if (multiplier_ == 0U)
+            return value;
+        return static_cast<uint32_t>((static_cast<unsigned __int128>(multiplier_) * value) >> 64);
+    }
+
+    uint32_t remainder(uint32_t value) const
+    {
+        uint64_t fraction = multiplier_ * value;
+        return static_cast<uint32_t>((static_cast<unsigned __int128>(fraction) * divisor_) >> 64);
+    }
+
+private:
+    uint32_t divisor_;
+    uint64_t multiplier_;
+};
+
+} // namespace aoc
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+// Dense 2D grid stored row-major in one block, with a halo of `halo` cells
+// on every side. Halo cells are real storage (zero-initialised unless the
+// caller writes them), so a stencil over the interior may read or update its
+// neighbours at offsets up to the halo without bounds checks:
+//
+//   aoc::Grid<int> counts(rows, cols, 1, memory);
+//   counts(r - 1, c + 1)--;    // fine for every interior (r, c)
+//
+// Coordinates are signed: (0, 0) is the first interior cell and the halo is at
+// -halo..-1 and rows()..rows() + halo - 1 (likewise for columns). row(r) is
+// the interior of a row as a span; rowData(r)[-1] is its left halo cell.
+//
+// Grid<bool> is bit-packed, 64 cells per word, each padded row starting on a
+// word boundary. Cells are read with test() and written with set(); whole
+// rows are reachable as words through rowWords(), where column c is bit
+// bitOf(c), and forEachSet() visits the set cells of a row a word at a time.
+
+namespace aoc
+{
+
+template <typename T>
+class Grid
+{
+public:
+    using value_type = T;
+
+    Grid() : Grid(0U, 0U) {}
+
+    Grid(size_t rows, size_t cols, size_t halo = 1U, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+        : rows_(rows), cols_(cols), halo_(halo), stride_(cols + 2U * halo),
+          cells_((rows + 2U * halo) * stride_, T{}, memory)
+    {
+    }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t halo() const { return halo_; }
+
+    // Distance in elements between vertically adjacent cells
+    size_t stride() const { return stride_; }
+
+    T &operator()(ptrdiff_t r, ptrdiff_t c) { return cells_[index(r, c)]; }
+    const T &operator()(ptrdiff_t r, ptrdiff_t c) const { return cells_[index(r, c)]; }
+
+    // Column 0 of row r; the halo is reachable at negative offsets
+    T *rowData(ptrdiff_t r) { return cells_.data() + index(r, 0); }
+    const T *rowData(ptrdiff_t r) const { return cells_.data() + index(r, 0); }
+
+    std::span<T> row(ptrdiff_t r) { return {rowData(r), cols_}; }
+    std::span<const T> row(ptrdiff_t r) const { return {rowData(r), cols_}; }
+
+    std::pmr::memory_resource *resource() const { return cells_.get_allocator().resource(); }
+
+private:
+    size_t index(ptrdiff_t r, ptrdiff_t c) const
+    {
+        return static_cast<size_t>(r + static_cast<ptrdiff_t>(halo_)) * stride_ + static_cast<size_t>(c + static_cast<ptrdiff_t>(halo_));
+    }
+
+    size_t rows_;
+    size_t cols_;
+    size_t halo_;
+    size_t stride_;
+    std::pmr::vector<T> cells_;
+};
+
+template <>
+class Grid<bool>
+{
+public:
+    using value_type = bool;
+    static constexpr size_t WORD_BITS = 64U;
+
+    Grid() : Grid(0U, 0U) {}
+
+    Grid(size_t rows, size_t cols, size_t halo = 1U, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+        : rows_(rows), cols_(cols), halo_(halo), wordsPerRow_((cols + 2U * halo + WORD_BITS - 1U) / WORD_BITS),
+          words_((rows + 2U * halo) * wordsPerRow_, 0U, memory)
+    {
+    }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t halo() const { return halo_; }
+    size_t wordsPerRow() const { return wordsPerRow_; }
+
+    // Bit of column c within its row's words
+    size_t bitOf(ptrdiff_t c) const { return static_cast<size_t>(c + static_cast<ptrdiff_t>(halo_)); }
+
+    bool test(ptrdiff_t r, ptrdiff_t c) const
+    {
+        size_t bit = bitOf(c);
+        return (rowWords(r)[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1U;
+    }
+
+    void set(ptrdiff_t r, ptrdiff_t c, bool value = true)
+    {
+        size_t bit = bitOf(c);
+        uint64_t mask = uint64_t{1} << (bit % WORD_BITS);
+        uint64_t &word = rowWords(r)[bit / WORD_BITS];
+        word = value ? word | mask : word & ~mask;
+    }
+
+    bool operator()(ptrdiff_t r, ptrdiff_t c) const { return test(r, c); }
+
+    std::span<uint64_t> rowWords(ptrdiff_t r) { return {words_.data() + rowOffset(r), wordsPerRow_}; }
+    std::span<const uint64_t> rowWords(ptrdiff_t r) const { return {words_.data() + rowOffset(r), wordsPerRow_}; }
+
+    // Calls visit(c) for every set cell of row r, in column order
+    template <typename Visit>
+    void forEachSet(ptrdiff_t r, Visit &&visit) const
+    {
+        std::span<const uint64_t> words = rowWords(r);
+        for (size_t w = 0; w < words.size(); ++w)
+        {
+            for (uint64_t bits = words[w]; bits != 0U; bits &= bits - 1U)
+            {
+                size_t bit = w * WORD_BITS + std::countr_zero(bits);
+                visit(static_cast<ptrdiff_t>(bit) - static_cast<ptrdiff_t>(halo_));
+            }
+        }
+    }
+
+    std::pmr::memory_resource *resource() const { return words_.get_allocator().resource(); }
+
+private:
+    size_t rowOffset(ptrdiff_t r) const { return static_cast<size_t>(r + static_cast<ptrdiff_t>(halo_)) * wordsPerRow_; }
+
+    size_t rows_;
+    size_t cols_;
+    size_t halo_;
+    size_t wordsPerRow_;
+    std::pmr::vector<uint64_t> words_;
+};
+
+} // namespace aoc
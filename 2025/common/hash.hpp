@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// XXH64 content hash (the reference algorithm, little-endian loads), used to
+// key caches by the bytes of an input rather than by its path or mtime.
+
+namespace aoc
+{
+
+namespace detail
+{
+
+constexpr uint64_t XXH_PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t read64(const char *cursor)
+{
+    uint64_t value;
+    std::memcpy(&value, cursor, sizeof(value));
+    return value;
+}
+
+inline uint32_t read32(const char *cursor)
+{
+    uint32_t value;
+    std::memcpy(&value, cursor, sizeof(value));
+    return value;
+}
+
+inline uint64_t xxhRound(uint64_t accumulator, uint64_t input)
+{
+    accumulator += input * XXH_PRIME2;
+    return rotateLeft(accumulator, 31) * XXH_PRIME1;
+}
+
+inline uint64_t xxhMerge(uint64_t hash, uint64_t accumulator)
+{
+    hash ^= xxhRound(0U, accumulator);
+    return hash * XXH_PRIME1 + XXH_PRIME4;
+}
+
+} // namespace detail
+
+inline uint64_t xxh64(std::string_view data, uint64_t seed = 0U)
+{
+    using namespace detail;
+
+    const char *cursor = data.data();
+    const char *end = cursor + data.size();
+    uint64_t hash;
+
+    if (data.size() >= 32U)
+    {
+        uint64_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+        uint64_t v2 = seed + XXH_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_PRIME1;
+        for (; end - cursor >= 32; cursor += 32)
+        {
+            v1 = xxhRound(v1, read64(cursor));
+            v2 = xxhRound(v2, read64(cursor + 8));
+            v3 = xxhRound(v3, read64(cursor + 16));
+            v4 = xxhRound(v4, read64(cursor + 24));
+        }
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        hash = xxhMerge(hash, v1);
+        hash = xxhMerge(hash, v2);
+        hash = xxhMerge(hash, v3);
+        hash = xxhMerge(hash, v4);
+    }
+    else
+    {
+        hash = seed + XXH_PRIME5;
+    }
+
+    hash += data.size();
+    for (; end - cursor >= 8; cursor += 8)
+        hash = rotateLeft(hash ^ xxhRound(0U, read64(cursor)), 27) * XXH_PRIME1 + XXH_PRIME4;
+    if (end - cursor >= 4)
+    {
+        hash = rotateLeft(hash ^ (read32(cursor) * XXH_PRIME1), 23) * XXH_PRIME2 + XXH_PRIME3;
+        cursor += 4;
+    }
+    for (; cursor < end; ++cursor)
+        hash = rotateLeft(hash ^ (static_cast<uint8_t>(*cursor) * XXH_PRIME5), 11) * XXH_PRIME1;
+
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// 16 lowercase hex digits, for file names
+inline std::string hashToHex(uint64_t hash)
+{
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i, hash >>= 4)
+        hex[i] = DIGITS[hash & 0xFU];
+    return hex;
+}
+
+} // namespace aoc
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <sys/mman.h>
+
+// Huge-page backing for the large dense tables (day 08's pair distances, the
+// parse arenas holding day 04's grids, day 10's visited set). With 4 KiB pages
+// a table of a few hundred MiB needs far more TLB entries than the CPU has,
+// so a scan over it misses the TLB on nearly every page; 2 MiB pages cut the
+// entries needed 512-fold.
+//
+// Large tables are allocated from largeTableResource(). With huge pages off
+// (the default) that is the default heap resource. Otherwise blocks of at
+// least HUGE_PAGE_MIN_BYTES are mapped on their own, 2 MiB aligned, and
+//
+//   thp      advised with madvise(MADV_HUGEPAGE), so the kernel backs them with
+//            transparent huge pages when it has them
+//   hugetlb  mapped from the reserved hugetlbfs pool (MAP_HUGETLB), falling
+//            back to thp when the pool is empty or not set up
+//
+// A block that cannot be mapped at all comes from the heap, so turning huge
+// pages on never makes an allocation fail. Smaller blocks always come from
+// the heap. The mode is set with hugepages::configure() (aoc --huge-pages)
+// or AOC_HUGE_PAGES=off|thp|hugetlb before first use.
+
+namespace aoc
+{
+
+constexpr size_t HUGE_PAGE_BYTES = 2U << 20;
+
+// Blocks smaller than this would waste most of a huge page
+constexpr size_t HUGE_PAGE_MIN_BYTES = HUGE_PAGE_BYTES / 2U;
+
+enum class HugePageMode : uint8_t
+{
+    OFF,
+    TRANSPARENT, // madvise(MADV_HUGEPAGE)
+    HUGETLB,     // MAP_HUGETLB, then TRANSPARENT
+};
+
+constexpr const char *hugePageModeName(HugePageMode mode)
+{
+    switch (mode)
+    {
+    case HugePageMode::OFF:
+        return "off";
+    case HugePageMode::TRANSPARENT:
+        return "thp";
+    case HugePageMode::HUGETLB:
+        return "hugetlb";
+    default:
+        return "unknown";
+    }
+}
+
+inline bool parseHugePageMode(std::string_view name, HugePageMode &mode)
+{
+    for (auto candidate : {HugePageMode::OFF, HugePageMode::TRANSPARENT, HugePageMode::HUGETLB})
+    {
+        if (name == hugePageModeName(candidate))
+        {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// How the large blocks handed out so far were backed
+struct HugePageStats
+{
+    uint64_t hugetlbBlocks = 0U;
+    uint64_t transparentBlocks = 0U;
+    uint64_t heapBlocks = 0U; // mapping failed, served by the heap instead
+    uint64_t mappedBytes = 0U;
+};
+
+class HugePageResource : public std::pmr::memory_resource
+{
+public:
+    explicit HugePageResource(HugePageMode mode, std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+        : mode_(mode), upstream_(upstream)
+    {
+    }
+
+    HugePageMode mode() const { return mode_; }
+
+    HugePageStats stats() const
+    {
+        return {hugetlbBlocks_.load(std::memory_order_relaxed), transparentBlocks_.load(std::memory_order_relaxed),
+                heapBlocks_.load(std::memory_order_relaxed), mappedBytes_.load(std::memory_order_relaxed)};
+    }
+
+private:
+    static size_t roundUp(size_t bytes) { return (bytes + HUGE_PAGE_BYTES - 1U) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES; }
+
+    // Anonymous mapping of `length` bytes (a multiple of 2 MiB) on a 2 MiB
+    // boundary: over-map by one huge page and trim both ends
+    static void *mapAligned(size_t length)
+    {
+        void *raw = ::mmap(nullptr, length + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            return nullptr;
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (start + HUGE_PAGE_BYTES - 1U) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+        if (aligned > start)
+            ::munmap(raw, aligned - start);
+        ::munmap(reinterpret_cast<void *>(aligned + length), start + HUGE_PAGE_BYTES - aligned);
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    void *mapHuge(size_t length)
+    {
+        if (mode_ == HugePageMode::HUGETLB)
+        {
+            void *block = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (block != MAP_FAILED)
+            {
+                hugetlbBlocks_.fetch_add(1U, std::memory_order_relaxed);
+                return block;
+            }
+        }
+
+        void *block = mapAligned(length);
+        if (block == nullptr)
+            return nullptr;
+        // Advice the kernel may not take (THP off); the block is usable either way
+        ::madvise(block, length, MADV_HUGEPAGE);
+        transparentBlocks_.fetch_add(1U, std::memory_order_relaxed);
+        return block;
+    }
+
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (mode_ == HugePageMode::OFF || bytes < HUGE_PAGE_MIN_BYTES || alignment > HUGE_PAGE_BYTES)
+            return upstream_->allocate(bytes, alignment);
+
+        size_t length = roundUp(bytes);
+        void *block = mapHuge(length);
+        if (block == nullptr)
+        {
+            heapBlocks_.fetch_add(1U, std::memory_order_relaxed);
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        mappedBytes_.fetch_add(length, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex_);
+        mapped_.emplace(block, length);
+        return block;
+    }
+
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override
+    {
+        if (bytes >= HUGE_PAGE_MIN_BYTES)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto it = mapped_.find(pointer);
+            if (it != mapped_.end())
+            {
+                size_t length = it->second;
+                mapped_.erase(it);
+                lock.unlock();
+                ::munmap(pointer, length);
+                return;
+            }
+        }
+        upstream_->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    HugePageMode mode_;
+    std::pmr::memory_resource *upstream_;
+    std::mutex mutex_;
+    std::unordered_map<void *, size_t> mapped_; // mapped block -> mapped length
+    std::atomic<uint64_t> hugetlbBlocks_{0U};
+    std::atomic<uint64_t> transparentBlocks_{0U};
+    std::atomic<uint64_t> heapBlocks_{0U};
+    std::atomic<uint64_t> mappedBytes_{0U};
+};
+
+namespace hugepages
+{
+
+namespace detail
+{
+
+inline HugePageMode &requestedMode()
+{
+    static HugePageMode mode = []
+    {
+        HugePageMode fromEnvironment = HugePageMode::OFF;
+        const char *name = std::getenv("AOC_HUGE_PAGES");
+        if (name != nullptr)
+            parseHugePageMode(name, fromEnvironment);
+        return fromEnvironment;
+    }();
+    return mode;
+}
+
+} // namespace detail
+
+// Sets the mode of the shared resource; only effective before resource()
+inline void configure(HugePageMode mode) { detail::requestedMode() = mode; }
+
+inline HugePageResource &resource()
+{
+    static HugePageResource shared(detail::requestedMode());
+    return shared;
+}
+
+} // namespace hugepages
+
+// Where large dense tables should be allocated
+inline std::pmr::memory_resource *largeTableResource()
+{
+    HugePageResource &huge = hugepages::resource();
+    return huge.mode() == HugePageMode::OFF ? std::pmr::get_default_resource() : &huge;
+}
+
+} // namespace aoc
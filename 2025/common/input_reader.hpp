@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aoc
+{
+
+// Forward-only range over the lines of a buffer. Lines are returned without
+// their terminating '\n' (and '\r' for CRLF files); nothing is copied.
+class LineRange
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view &;
+
+        Iterator() = default;
+        Iterator(const char *cursor, const char *end) : cursor_(cursor), end_(end)
+        {
+            advance();
+        }
+
+        reference operator*() const { return line_; }
+        pointer operator->() const { return &line_; }
+
+        Iterator &operator++()
+        {
+            advance();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator copy = *this;
+            advance();
+            return copy;
+        }
+
+        bool operator==(const Iterator &other) const { return atEnd_ == other.atEnd_ && (atEnd_ || line_.data() == other.line_.data()); }
+
+    private:
+        void advance()
+        {
+            if (cursor_ == nullptr || cursor_ >= end_)
+            {
+                atEnd_ = true;
+                line_ = {};
+                return;
+            }
+
+            const char *newline = static_cast<const char *>(std::memchr(cursor_, '\n', end_ - cursor_));
+            const char *lineEnd = newline ? newline : end_;
+            size_t length = lineEnd - cursor_;
+            if (length > 0 && cursor_[length - 1] == '\r')
+                length--;
+
+            line_ = std::string_view(cursor_, length);
+            cursor_ = newline ? newline + 1 : end_;
+            atEnd_ = false;
+        }
+
+        const char *cursor_ = nullptr;
+        const char *end_ = nullptr;
+        std::string_view line_;
+        bool atEnd_ = true;
+    };
+
+    explicit LineRange(std::string_view buffer) : buffer_(buffer) {}
+
+    Iterator begin() const { return Iterator(buffer_.data(), buffer_.data() + buffer_.size()); }
+    Iterator end() const { return Iterator(); }
+
+private:
+    std::string_view buffer_;
+};
+
+// Splits a line on a single separator character without allocating, e.g.
+// "1,2,3" -> "1", "2", "3". Empty fields between repeated separators are
+// returned as empty views.
+class FieldSplitter
+{
+public:
+    FieldSplitter(std::string_view text, char separator) : text_(text), separator_(separator) {}
+
+    // Returns false once every field has been consumed
+    bool next(std::string_view &field)
+    {
+        if (done_)
+            return false;
+
+        size_t separatorPos = text_.find(separator_);
+        if (separatorPos == std::string_view::npos)
+        {
+            field = text_;
+            done_ = true;
+            return true;
+        }
+
+        field = text_.substr(0, separatorPos);
+        text_.remove_prefix(separatorPos + 1);
+        return true;
+    }
+
+private:
+    std::string_view text_;
+    char separator_;
+    bool done_ = false;
+};
+
+// read(2) that retries when a signal interrupts it before any data arrives
+inline ssize_t readRetrying(int fd, void *buffer, size_t bytes)
+{
+    ssize_t bytesRead;
+    do
+        bytesRead = ::read(fd, buffer, bytes);
+    while (bytesRead < 0 && errno == EINTR);
+    return bytesRead;
+}
+
+// Read-only view of a whole input file. Regular files are memory-mapped with a
+// sequential access hint; "-" reads standard input, and anything that cannot be
+// mapped (pipes, character devices, empty files) falls back to a single heap
+// buffer.
+class InputFile
+{
+public:
+    explicit InputFile(std::string const &filePath)
+    {
+        if (filePath == "-")
+        {
+            readAll(STDIN_FILENO);
+            return;
+        }
+
+        int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        struct stat fileStat;
+        if (::fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0)
+        {
+            void *mapping = ::mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                ::madvise(mapping, fileStat.st_size, MADV_SEQUENTIAL);
+                data_ = static_cast<const char *>(mapping);
+                size_ = fileStat.st_size;
+                mapped_ = true;
+                isOpen_ = true;
+                ::close(fd);
+                return;
+            }
+        }
+
+        readAll(fd);
+        ::close(fd);
+    }
+
+    ~InputFile()
+    {
+        if (mapped_)
+            ::munmap(const_cast<char *>(data_), size_);
+    }
+
+    InputFile(const InputFile &) = delete;
+    InputFile &operator=(const InputFile &) = delete;
+
+    bool isOpen() const { return isOpen_; }
+    std::string_view contents() const { return {data_, size_}; }
+    LineRange lines() const { return LineRange(contents()); }
+
+private:
+    void readAll(int fd)
+    {
+        char chunk[1 << 16];
+        ssize_t bytesRead;
+        while ((bytesRead = readRetrying(fd, chunk, sizeof(chunk))) > 0)
+        {
+            fallback_.append(chunk, bytesRead);
+        }
+        if (bytesRead < 0)
+            return;
+
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+        isOpen_ = true;
+    }
+
+    const char *data_ = "";
+    size_t size_ = 0U;
+    bool mapped_ = false;
+    bool isOpen_ = false;
+    std::string fallback_;
+};
+
+} // namespace aoc
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "common/cpu_dispatch.hpp"
+
+#ifdef AOC_DISPATCH_X86
+#include <immintrin.h>
+#define AOC_PARSE_X86 1
+#endif
+
+// Locale-free decimal parsing straight from a character cursor. Every parser
+// returns the position just past the last consumed character so callers can
+// keep scanning the same buffer; when no digit is found the cursor is returned
+// unchanged and the value is left at zero. Values are assumed to fit in the
+// destination type (no overflow detection, same as the std::sto* calls these
+// replace were never asked to handle).
+
+namespace aoc
+{
+
+namespace detail
+{
+
+inline uint64_t loadWord(const char *cursor)
+{
+    uint64_t word;
+    std::memcpy(&word, cursor, sizeof(word));
+    return word;
+}
+
+// High bit set in every byte of the word that is not '0'..'9'
+inline uint64_t nonDigitMask(uint64_t word)
+{
+    constexpr uint64_t LOW7 = 0x7F7F7F7F7F7F7F7FULL;
+    constexpr uint64_t HIGH = 0x8080808080808080ULL;
+    uint64_t low = word & LOW7;
+    uint64_t aboveNine = low + 0x4646464646464646ULL;     // bit 7 set when byte >= ':'
+    uint64_t atLeastZero = low + 0x5050505050505050ULL;   // bit 7 set when byte >= '0'
+    return (word | aboveNine | ~atLeastZero) & HIGH;
+}
+
+// Converts 8 ASCII digits (first digit in the lowest byte) to their value.
+// Bytes that are 0x00 act as leading zeros.
+inline uint32_t convertEightDigits(uint64_t word)
+{
+    word = ((word & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    word = ((word & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return static_cast<uint32_t>(((word & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+
+// Parses up to 8 digits with a single word load. Returns the digit count.
+inline unsigned parseWord(const char *cursor, uint32_t &value)
+{
+    uint64_t word = loadWord(cursor);
+    uint64_t mask = nonDigitMask(word);
+    unsigned digits = mask ? (__builtin_ctzll(mask) >> 3) : 8U;
+    if (digits == 0)
+    {
+        value = 0;
+        return 0;
+    }
+
+    value = convertEightDigits(word << (8U * (8U - digits)));
+    return digits;
+}
+
+#ifdef AOC_PARSE_X86
+// Parses up to 16 digits with one 16-byte load. Returns the digit count.
+AOC_TARGET_SSE42 inline unsigned parseSixteenSse(const char *cursor, uint64_t &value)
+{
+    // Window into this table right-aligns the digit run, zeroing the lanes before it
+    alignas(16) static constexpr int8_t SHIFT_TABLE[32] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cursor));
+    __m128i shifted = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+    __m128i isDigit = _mm_cmplt_epi8(_mm_xor_si128(shifted, _mm_set1_epi8(-128)), _mm_set1_epi8(-128 + 10));
+    unsigned nonDigits = ~static_cast<unsigned>(_mm_movemask_epi8(isDigit)) & 0xFFFFU;
+    unsigned digits = nonDigits ? __builtin_ctz(nonDigits) : 16U;
+
+    __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(SHIFT_TABLE + digits));
+    __m128i aligned = _mm_shuffle_epi8(shifted, shuffle);
+
+    __m128i pairs = _mm_maddubs_epi16(aligned, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    __m128i packed = _mm_packus_epi32(quads, quads);
+    __m128i octets = _mm_madd_epi16(packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+    uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+    uint64_t low = static_cast<uint32_t>(_mm_extract_epi32(octets, 1));
+    value = high * 100000000ULL + low;
+    return digits;
+}
+
+AOC_TARGET_AVX2 inline size_t digitRunLengthAvx2(const char *cursor, const char *end)
+{
+    const char *start = cursor;
+    while (end - cursor >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cursor));
+        __m256i shifted = _mm256_xor_si256(_mm256_sub_epi8(chunk, _mm256_set1_epi8('0')), _mm256_set1_epi8(-128));
+        __m256i isDigit = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 10), shifted);
+        unsigned nonDigits = ~static_cast<unsigned>(_mm256_movemask_epi8(isDigit));
+        if (nonDigits)
+            return (cursor - start) + __builtin_ctz(nonDigits);
+        cursor += 32;
+    }
+    while (cursor < end && static_cast<unsigned char>(*cursor - '0') < 10U)
+        cursor++;
+    return cursor - start;
+}
+
+AOC_TARGET_AVX512 inline size_t digitRunLengthAvx512(const char *cursor, const char *end)
+{
+    const char *start = cursor;
+    while (end - cursor >= 64)
+    {
+        __m512i chunk = _mm512_loadu_si512(cursor);
+        __m512i shifted = _mm512_sub_epi8(chunk, _mm512_set1_epi8('0'));
+        uint64_t nonDigits = _mm512_cmpge_epu8_mask(shifted, _mm512_set1_epi8(10));
+        if (nonDigits)
+            return (cursor - start) + __builtin_ctzll(nonDigits);
+        cursor += 64;
+    }
+    return (cursor - start) + digitRunLengthAvx2(cursor, end);
+}
+#endif
+
+inline uint64_t pow10(unsigned exponent)
+{
+    static constexpr uint64_t POWERS[] = {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL};
+    return POWERS[exponent];
+}
+
+} // namespace detail
+
+inline bool isDigit(char ch)
+{
+    return static_cast<unsigned char>(ch - '0') < 10U;
+}
+
+// Length of the run of ASCII digits starting at cursor. Long runs (such as
+// day_03's battery banks) are scanned 64 or 32 bytes at a time at the
+// AVX-512 and AVX2 dispatch levels.
+inline size_t digitRunLength(const char *cursor, const char *end)
+{
+#ifdef AOC_PARSE_X86
+    if (end - cursor >= 64 && cpu::supports(cpu::IsaLevel::AVX512))
+        return detail::digitRunLengthAvx512(cursor, end);
+    if (end - cursor >= 32 && cpu::supports(cpu::IsaLevel::AVX2))
+        return detail::digitRunLengthAvx2(cursor, end);
+#endif
+    const char *start = cursor;
+    while (cursor < end && isDigit(*cursor))
+        cursor++;
+    return cursor - start;
+}
+
+// Parses an unsigned decimal at cursor. Numbers of up to 7 digits take a
+// single word load; longer runs continue 8 digits per word, or 16 per step
+// at the SSE4.2 dispatch level and above when the buffer is long enough.
+template <typename T>
+const char *parseUnsigned(const char *cursor, const char *end, T &value)
+{
+    static_assert(std::is_integral_v<T>, "parseUnsigned needs an integral type");
+
+    uint64_t result = 0;
+    if (end - cursor >= 8)
+    {
+        uint64_t word = detail::loadWord(cursor);
+        uint64_t mask = detail::nonDigitMask(word);
+        if (mask)
+        {
+            unsigned digits = __builtin_ctzll(mask) >> 3;
+            value = digits ? static_cast<T>(detail::convertEightDigits(word << (8U * (8U - digits)))) : T{};
+            return cursor + digits;
+        }
+
+#ifdef AOC_PARSE_X86
+        if (end - cursor >= 16 && cpu::supports(cpu::IsaLevel::SSE42))
+        {
+            unsigned digits = detail::parseSixteenSse(cursor, result);
+            cursor += digits;
+            if (digits < 16)
+            {
+                value = static_cast<T>(result);
+                return cursor;
+            }
+        }
+#endif
+    }
+
+    while (end - cursor >= 8)
+    {
+        uint32_t chunkValue;
+        unsigned digits = detail::parseWord(cursor, chunkValue);
+        if (digits == 0)
+            break;
+
+        result = (digits == 8 ? result * 100000000ULL : result * detail::pow10(digits)) + chunkValue;
+        cursor += digits;
+        if (digits < 8)
+        {
+            value = static_cast<T>(result);
+            return cursor;
+        }
+    }
+
+    // Tail of the buffer, too short for a word load
+    while (cursor < end && isDigit(*cursor))
+    {
+        result = result * 10 + static_cast<uint64_t>(*cursor - '0');
+        cursor++;
+    }
+
+    value = static_cast<T>(result);
+    return cursor;
+}
+
+// Parses an optionally signed ('+' or '-') decimal at cursor.
+template <typename T>
+const char *parseSigned(const char *cursor, const char *end, T &value)
+{
+    static_assert(std::is_signed_v<T>, "parseSigned needs a signed type");
+
+    bool negative = false;
+    const char *start = cursor;
+    if (cursor < end && (*cursor == '-' || *cursor == '+'))
+    {
+        negative = (*cursor == '-');
+        cursor++;
+    }
+
+    std::make_unsigned_t<T> magnitude = 0;
+    const char *digitsEnd = parseUnsigned(cursor, end, magnitude);
+    if (digitsEnd == cursor)
+    {
+        value = 0;
+        return start;
+    }
+
+    // Negating in the unsigned type keeps the most negative value (a magnitude
+    // one past T's maximum) defined
+    value = negative ? static_cast<T>(std::make_unsigned_t<T>{0} - magnitude) : static_cast<T>(magnitude);
+    return digitsEnd;
+}
+
+// Moves the cursor forward to the next digit (or '-' when signed values are
+// expected), skipping separators such as ',', ' ', '(' or '-'.
+inline const char *skipToNumber(const char *cursor, const char *end, bool allowSign = false)
+{
+    while (cursor < end && !isDigit(*cursor) && !(allowSign && *cursor == '-'))
+        cursor++;
+    return cursor;
+}
+
+// Converts a whole field to a number; non-numeric fields yield 0.
+template <typename T>
+T toNumber(std::string_view field)
+{
+    T value{};
+    if constexpr (std::is_signed_v<T>)
+        parseSigned(field.data(), field.data() + field.size(), value);
+    else
+        parseUnsigned(field.data(), field.data() + field.size(), value);
+    return value;
+}
+
+} // namespace aoc
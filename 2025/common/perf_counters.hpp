@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Hardware performance counters around solver phases, backed by Linux
+// perf_event_open. Each event is opened on its own so one missing counter
+// (no dTLB event on this CPU, a VM without a PMU, perf_event_paranoid too
+// strict) only disables that counter; everything else keeps working and a
+// reader sees it as unavailable rather than as zero.
+//
+// Counters measure user space of the calling thread only, which keeps them
+// usable at perf_event_paranoid = 2.
+
+namespace aoc
+{
+
+enum class Counter : uint8_t
+{
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    DTLB_MISSES,
+    COUNT
+};
+
+constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);
+
+constexpr const char *counterName(Counter counter)
+{
+    switch (counter)
+    {
+    case Counter::CYCLES:
+        return "cycles";
+    case Counter::INSTRUCTIONS:
+        return "instructions";
+    case Counter::CACHE_MISSES:
+        return "cache_misses";
+    case Counter::BRANCH_MISSES:
+        return "branch_misses";
+    case Counter::DTLB_MISSES:
+        return "dtlb_misses";
+    default:
+        return "unknown";
+    }
+}
+
+struct CounterValues
+{
+    std::array<uint64_t, COUNTER_COUNT> values{};
+    std::array<bool, COUNTER_COUNT> valid{};
+
+    uint64_t operator[](Counter counter) const { return values[static_cast<size_t>(counter)]; }
+    bool has(Counter counter) const { return valid[static_cast<size_t>(counter)]; }
+
+    CounterValues &operator+=(const CounterValues &other)
+    {
+        for (size_t i = 0; i < COUNTER_COUNT; ++i)
+        {
+            values[i] += other.values[i];
+            valid[i] = valid[i] || other.valid[i];
+        }
+        return *this;
+    }
+
+    // Instructions per cycle, or 0 when either counter is missing
+    double ipc() const
+    {
+        if (!has(Counter::CYCLES) || !has(Counter::INSTRUCTIONS) || (*this)[Counter::CYCLES] == 0U)
+            return 0.0;
+        return static_cast<double>((*this)[Counter::INSTRUCTIONS]) / (*this)[Counter::CYCLES];
+    }
+};
+
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+        fds_.fill(-1);
+        open(Counter::CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open(Counter::INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open(Counter::CACHE_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open(Counter::BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        open(Counter::DTLB_MISSES, PERF_TYPE_HW_CACHE,
+             PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    }
+
+    ~PerfCounters()
+    {
+        for (int fd : fds_)
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available(Counter counter) const { return fds_[static_cast<size_t>(counter)] >= 0; }
+
+    // errno of the first counter that failed to open, 0 if all opened
+    int error() const { return error_; }
+
+    bool anyAvailable() const
+    {
+        for (int fd : fds_)
+        {
+            if (fd >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Running totals since the counters were opened. When the kernel had to
+    // multiplex events the raw count is scaled by enabled / running time.
+    CounterValues read() const
+    {
+        CounterValues sample;
+        for (size_t i = 0; i < COUNTER_COUNT; ++i)
+        {
+            if (fds_[i] < 0)
+                continue;
+
+            uint64_t data[3] = {}; // value, time enabled, time running
+            if (::read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+                continue;
+
+            double scale = data[2] > 0U && data[2] < data[1] ? static_cast<double>(data[1]) / data[2] : 1.0;
+            sample.values[i] = static_cast<uint64_t>(data[0] * scale);
+            sample.valid[i] = true;
+        }
+        return sample;
+    }
+
+    // Difference between two readings of the same counters
+    static CounterValues delta(const CounterValues &start, const CounterValues &end)
+    {
+        CounterValues result;
+        for (size_t i = 0; i < COUNTER_COUNT; ++i)
+        {
+            result.valid[i] = start.valid[i] && end.valid[i];
+            result.values[i] = result.valid[i] && end.values[i] > start.values[i] ? end.values[i] - start.values[i] : 0U;
+        }
+        return result;
+    }
+
+private:
+    void open(Counter counter, uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0UL);
+        fds_[static_cast<size_t>(counter)] = static_cast<int>(fd);
+        if (fd < 0 && error_ == 0)
+            error_ = errno;
+    }
+
+    std::array<int, COUNTER_COUNT> fds_;
+    int error_ = 0;
+};
+
+} // namespace aoc
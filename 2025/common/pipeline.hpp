@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "common/input_reader.hpp"
+#include "common/thread_pool.hpp"
+
+// Bounded parse/solve pipeline for days whose lines can be handled
+// independently:
+//
+//   ChunkSource  cuts the input into chunks of whole lines, either views into
+//                a buffer or bytes read from a file descriptor;
+//   process      runs on the pool, turning one chunk into a partial result;
+//   fold         runs on the calling thread and receives the partial results
+//                strictly in input order.
+//
+// At most `window` chunks are in flight, so memory stays at about
+// window * chunk size whatever the input size. Results that depend on what
+// came before (day 01's dial) fold an associative summary per chunk.
+
+namespace aoc
+{
+
+class ChunkSource
+{
+public:
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 1U << 20;
+
+    // Chunks are views into `text`, which must outlive the source
+    explicit ChunkSource(std::string_view text, size_t chunkBytes = DEFAULT_CHUNK_BYTES)
+        : text_(text), chunkBytes_(std::max<size_t>(chunkBytes, 1U))
+    {
+    }
+
+    // Chunks are read from `fd` (a pipe, stdin, a file) into caller storage
+    explicit ChunkSource(int fd, size_t chunkBytes = DEFAULT_CHUNK_BYTES)
+        : fd_(fd), chunkBytes_(std::max<size_t>(chunkBytes, 1U))
+    {
+    }
+
+    // Produces the next chunk of whole lines. `storage` is used (and reused)
+    // when bytes have to be copied; `chunk` may point into it. Returns false
+    // once the input is exhausted.
+    bool next(std::string &storage, std::string_view &chunk)
+    {
+        return fd_ >= 0 ? nextFromFd(storage, chunk) : nextFromText(chunk);
+    }
+
+    // Total bytes handed out so far
+    size_t consumed() const { return consumed_; }
+
+private:
+    bool nextFromText(std::string_view &chunk)
+    {
+        if (text_.empty())
+            return false;
+
+        size_t cut = text_.size();
+        if (cut > chunkBytes_)
+        {
+            size_t newline = text_.find('\n', chunkBytes_ - 1U);
+            cut = newline == std::string_view::npos ? text_.size() : newline + 1U;
+        }
+        chunk = text_.substr(0, cut);
+        text_.remove_prefix(cut);
+        consumed_ += cut;
+        return true;
+    }
+
+    bool nextFromFd(std::string &storage, std::string_view &chunk)
+    {
+        // Start from whatever followed the last line break of the previous read
+        storage.assign(carry_);
+        carry_.clear();
+
+        while (!eof_ && storage.size() < chunkBytes_)
+        {
+            size_t offset = storage.size();
+            storage.resize(chunkBytes_);
+            ssize_t bytesRead = readRetrying(fd_, storage.data() + offset, storage.size() - offset);
+            storage.resize(offset + (bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0U));
+            if (bytesRead <= 0)
+                eof_ = true;
+        }
+
+        if (storage.empty())
+            return false;
+
+        if (!eof_)
+        {
+            // Hand out whole lines only; keep the tail for the next chunk. A
+            // line longer than a chunk grows the buffer until it ends.
+            size_t newline = storage.rfind('\n');
+            while (newline == std::string::npos && !eof_)
+            {
+                size_t offset = storage.size(), step = std::min(READ_BYTES, chunkBytes_);
+                storage.resize(offset + step);
+                ssize_t bytesRead = readRetrying(fd_, storage.data() + offset, step);
+                storage.resize(offset + (bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0U));
+                if (bytesRead <= 0)
+                    eof_ = true;
+                newline = storage.rfind('\n');
+            }
+            if (newline != std::string::npos && newline + 1U < storage.size())
+            {
+                carry_.assign(storage, newline + 1U);
+                storage.resize(newline + 1U);
+            }
+        }
+
+        chunk = storage;
+        consumed_ += storage.size();
+        return true;
+    }
+
+    static constexpr size_t READ_BYTES = 64U << 10;
+
+    std::string_view text_;
+    int fd_ = -1;
+    size_t chunkBytes_;
+    std::string carry_;
+    bool eof_ = false;
+    size_t consumed_ = 0U;
+};
+
+// Runs process(chunk) for every chunk of `source` on the pool and calls
+// fold(result) with the results in input order on the calling thread. window
+// is the number of chunks in flight (0: twice the pool size).
+template <typename Process, typename Fold>
+void runPipeline(ChunkSource &source, Process &&process, Fold &&fold, size_t window = 0U,
+                 ThreadPool &pool = ThreadPool::instance())
+{
+    using Result = std::invoke_result_t<Process &, std::string_view>;
+
+    struct Slot
+    {
+        std::string storage;
+        std::string_view chunk;
+        std::optional<Result> result;
+        std::exception_ptr error;
+        std::atomic<bool> ready = false;
+    };
+
+    if (window == 0U)
+        window = 2U * pool.size();
+    std::vector<Slot> slots(window);
+
+    // Waits for the slot's chunk, helping with pool work meanwhile, and folds it
+    auto drain = [&](Slot &slot)
+    {
+        while (!slot.ready.load(std::memory_order_acquire))
+        {
+            if (!pool.runOne())
+                std::this_thread::yield();
+        }
+        if (slot.error)
+            std::rethrow_exception(slot.error);
+        fold(std::move(*slot.result));
+        slot.result.reset();
+    };
+
+    TaskGroup group(pool);
+    size_t produced = 0U, folded = 0U;
+    try
+    {
+        for (;;)
+        {
+            Slot &slot = slots[produced % window];
+            if (produced - folded == window)
+                drain(slots[folded++ % window]);
+
+            if (!source.next(slot.storage, slot.chunk))
+                break;
+
+            slot.ready.store(false, std::memory_order_relaxed);
+            group.run([&process, &slot]
+                      {
+                try
+                {
+                    slot.result.emplace(process(slot.chunk));
+                }
+                catch (...)
+                {
+                    slot.error = std::current_exception();
+                }
+                slot.ready.store(true, std::memory_order_release); });
+            ++produced;
+        }
+
+        while (folded < produced)
+            drain(slots[folded++ % window]);
+    }
+    catch (...)
+    {
+        group.wait();
+        throw;
+    }
+    group.wait();
+}
+
+} // namespace aoc
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "common/hash.hpp"
+
+// On-disk cache of answers, keyed by what determines them: day, part, solver
+// version and the XXH64 of the input. A repeated run on unchanged input reads
+// its answer back instead of solving; bumping a day's solver version in the
+// DAYS table retires its old answers. Days may also key finer-grained
+// results (day 10 caches every machine on its own), so an edit to one record
+// only re-solves that record.
+//
+// The file is a line per answer ("day part version hash answer") after an
+// "aoc-results 1" header; a later line for the same key wins. Stored answers
+// are buffered and appended through one open stream on flush(), which
+// Solver::solve calls once per part and the destructor calls at exit. The
+// cache is off unless a path is given with ResultCache::configure() (aoc
+// --results) or AOC_RESULT_CACHE before first use.
+
+namespace aoc
+{
+
+struct ResultKey
+{
+    int day;
+    int part;
+    int version;
+    uint64_t inputHash;
+
+    bool operator==(const ResultKey &other) const = default;
+};
+
+struct ResultKeyHash
+{
+    size_t operator()(const ResultKey &key) const
+    {
+        return std::hash<uint64_t>()(key.inputHash ^ (static_cast<uint64_t>(key.day) << 48) ^
+                                     (static_cast<uint64_t>(key.part) << 40) ^ static_cast<uint64_t>(key.version));
+    }
+};
+
+class ResultCache
+{
+public:
+    explicit ResultCache(std::string path) : path_(std::move(path))
+    {
+        if (!path_.empty())
+            load();
+    }
+
+    ~ResultCache() { flush(); }
+
+    ResultCache(const ResultCache &) = delete;
+    ResultCache &operator=(const ResultCache &) = delete;
+
+    // Sets the file of the shared cache; only effective before instance()
+    static void configure(std::string path) { requestedPath() = std::move(path); }
+
+    static ResultCache &instance()
+    {
+        static ResultCache cache(defaultPath());
+        return cache;
+    }
+
+    bool enabled() const { return !path_.empty(); }
+
+    std::optional<uint64_t> find(const ResultKey &key) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = answers_.find(key);
+        if (it == answers_.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    // Remembers an answer; its line reaches the file on the next flush()
+    void store(const ResultKey &key, uint64_t answer)
+    {
+        if (!enabled())
+            return;
+
+        std::string line = std::to_string(key.day) + ' ' + std::to_string(key.part) + ' ' + std::to_string(key.version) +
+                           ' ' + hashToHex(key.inputHash) + ' ' + std::to_string(answer) + '\n';
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        answers_.insert_or_assign(key, answer);
+        pending_ += line;
+    }
+
+    // Appends the answers stored since the last flush to the file
+    void flush()
+    {
+        // Held across the write so batches reach the file in store order
+        std::lock_guard<std::mutex> fileLock(fileMutex_);
+        std::string lines;
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            lines.swap(pending_);
+        }
+        if (lines.empty())
+            return;
+
+        if (!file_.is_open())
+        {
+            file_.open(path_, std::ios::app);
+            if (!file_.is_open())
+                return;
+            if (file_.tellp() == 0)
+                file_ << "aoc-results 1\n";
+        }
+        file_ << lines;
+        file_.flush();
+    }
+
+private:
+    static std::string &requestedPath()
+    {
+        static std::string path;
+        return path;
+    }
+
+    static std::string defaultPath()
+    {
+        if (!requestedPath().empty())
+            return requestedPath();
+        const char *path = std::getenv("AOC_RESULT_CACHE");
+        return path != nullptr ? path : "";
+    }
+
+    void load()
+    {
+        std::ifstream file(path_);
+        if (!file.is_open())
+            return;
+
+        std::string line;
+        if (!std::getline(file, line) || line != "aoc-results 1")
+        {
+            std::cerr << "Warning: ignoring result cache " << path_ << " with unknown format" << std::endl;
+            path_.clear();
+            return;
+        }
+
+        while (std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            ResultKey key{};
+            std::string hash;
+            uint64_t answer = 0;
+            if (fields >> key.day >> key.part >> key.version >> hash >> answer && hash.size() == 16U)
+            {
+                key.inputHash = std::strtoull(hash.c_str(), nullptr, 16);
+                answers_[key] = answer;
+            }
+        }
+    }
+
+    std::string path_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<ResultKey, uint64_t, ResultKeyHash> answers_;
+    std::string pending_; // stored lines not yet in the file
+    std::mutex fileMutex_;
+    std::ofstream file_;
+};
+
+} // namespace aoc
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "common/alloc_tracker.hpp"
+#include "common/arena.hpp"
+#include "common/binary_cache.hpp"
+#include "common/perf_counters.hpp"
+#include "common/result_cache.hpp"
+
+// Interface every day exposes to the aoc runner. A day is two functions: parse
+// builds the day's input structures from a buffer (into an arena it owns) and
+// solveParsed computes one part from them. Keeping them apart lets the runner
+// time each stage and schedule them as separate, dependent tasks.
+// Days that can save their parsed form in the binary cache (see
+// common/binary_cache.hpp) also expose store and load.
+// Attaching PerfCounters to the recorder also collects hardware counters per
+// phase, and enabling aoc::alloc adds heap usage per phase; days do not need
+// to know whether either happened.
+
+namespace aoc
+{
+
+using Answer = uint64_t;
+
+enum class Phase : uint8_t
+{
+    PARSE,
+    SOLVE,
+    COUNT
+};
+
+constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::COUNT);
+
+constexpr const char *phaseName(Phase phase)
+{
+    switch (phase)
+    {
+    case Phase::PARSE:
+        return "parse";
+    case Phase::SOLVE:
+        return "solve";
+    default:
+        return "unknown";
+    }
+}
+
+class PhaseRecorder
+{
+public:
+    // Runs work() and adds its wall time to the given phase. Returns whatever
+    // work() returns.
+    template <typename Work>
+    decltype(auto) measure(Phase phase, Work &&work)
+    {
+        Scope scope(*this, phase);
+        return std::forward<Work>(work)();
+    }
+
+    uint64_t nanoseconds(Phase phase) const { return elapsed_[static_cast<size_t>(phase)]; }
+
+    uint64_t totalNanoseconds() const
+    {
+        uint64_t total = 0U;
+        for (auto value : elapsed_)
+            total += value;
+        return total;
+    }
+
+    // Hardware counters accumulated per phase (all invalid when no counters
+    // are attached)
+    const CounterValues &counters(Phase phase) const { return counters_[static_cast<size_t>(phase)]; }
+
+    // Heap usage accumulated per phase (zero unless allocation tracking is on)
+    const AllocationStats &allocations(Phase phase) const { return allocations_[static_cast<size_t>(phase)]; }
+
+    // Starts collecting counters for every following measure(). The counters
+    // must outlive the recorder.
+    void attach(const PerfCounters *counters) { perf_ = counters; }
+
+    void reset()
+    {
+        elapsed_.fill(0U);
+        counters_.fill(CounterValues{});
+        allocations_.fill(AllocationStats{});
+    }
+
+private:
+    class Scope
+    {
+    public:
+        Scope(PhaseRecorder &recorder, Phase phase) : recorder_(recorder), phase_(phase)
+        {
+            if (recorder_.perf_ != nullptr)
+                startCounters_ = recorder_.perf_->read();
+            if (alloc::enabled())
+                startAllocations_ = alloc::mark();
+            start_ = std::chrono::steady_clock::now();
+        }
+
+        ~Scope()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            size_t index = static_cast<size_t>(phase_);
+            recorder_.elapsed_[index] += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            if (recorder_.perf_ != nullptr)
+                recorder_.counters_[index] += PerfCounters::delta(startCounters_, recorder_.perf_->read());
+            if (startAllocations_)
+                recorder_.allocations_[index] += alloc::since(*startAllocations_);
+        }
+
+    private:
+        PhaseRecorder &recorder_;
+        Phase phase_;
+        std::chrono::steady_clock::time_point start_;
+        CounterValues startCounters_;
+        std::optional<alloc::Mark> startAllocations_;
+    };
+
+    std::array<uint64_t, PHASE_COUNT> elapsed_{};
+    std::array<CounterValues, PHASE_COUNT> counters_{};
+    std::array<AllocationStats, PHASE_COUNT> allocations_{};
+    const PerfCounters *perf_ = nullptr;
+};
+
+// What a day's parse hands to its solveParsed. Days derive from it through
+// ParsedData; the runner only moves it around.
+class ParsedInput
+{
+public:
+    virtual ~ParsedInput() = default;
+};
+
+template <typename Data>
+class ParsedData : public ParsedInput
+{
+public:
+    template <typename Parser>
+    ParsedData(std::string_view input, Parser &&parser)
+        : arena(input), data(std::forward<Parser>(parser)(input, arena.resource()))
+    {
+    }
+
+    // Builds the data with builder(memory) into an arena of arenaBytes
+    template <typename Builder>
+    ParsedData(size_t arenaBytes, Builder &&builder)
+        : arena(arenaBytes), data(std::forward<Builder>(builder)(arena.resource()))
+    {
+    }
+
+    Arena arena; // declared first: data is built into it
+    Data data;
+};
+
+// Runs parser(input, memory) into a fresh arena sized for the input
+template <typename Parser>
+std::unique_ptr<ParsedInput> makeParsed(std::string_view input, Parser &&parser)
+{
+    using Data = std::invoke_result_t<Parser, std::string_view, std::pmr::memory_resource *>;
+    return std::make_unique<ParsedData<Data>>(input, std::forward<Parser>(parser));
+}
+
+// Runs loader(cache, memory) into a fresh arena sized for the cache file
+template <typename Loader>
+std::unique_ptr<ParsedInput> makeLoaded(const CacheFile &cache, Loader &&loader)
+{
+    using Data = std::invoke_result_t<Loader, const CacheFile &, std::pmr::memory_resource *>;
+    return std::make_unique<ParsedData<Data>>(cache.sizeBytes(), [&](std::pmr::memory_resource *memory)
+                                              { return std::forward<Loader>(loader)(cache, memory); });
+}
+
+// The data a day's own parse produced
+template <typename Data>
+Data &parsedData(ParsedInput &parsed)
+{
+    return static_cast<ParsedData<Data> &>(parsed).data;
+}
+
+using ParseFunction = std::unique_ptr<ParsedInput> (*)(std::string_view input, int part);
+using SolveParsedFunction = Answer (*)(ParsedInput &parsed, int part);
+using StoreFunction = void (*)(ParsedInput &parsed, CacheWriter &cache);
+using LoadFunction = std::unique_ptr<ParsedInput> (*)(const CacheFile &cache); // null if the columns do not fit
+
+// What one input element is for a day, used to normalise per-input metrics
+enum class InputUnit : uint8_t
+{
+    LINES,  // one record per line
+    FIELDS, // comma separated records
+    CELLS,  // one character of a grid
+};
+
+inline size_t countElements(std::string_view input, InputUnit unit)
+{
+    size_t count = 0U;
+    switch (unit)
+    {
+    case InputUnit::LINES:
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            if (input[i] != '\n' && input[i] != '\r' && (i + 1 == input.size() || input[i + 1] == '\n' || input[i + 1] == '\r'))
+                ++count;
+        }
+        break;
+    case InputUnit::FIELDS:
+        for (char c : input)
+            count += c == ',';
+        count += !input.empty();
+        break;
+    case InputUnit::CELLS:
+        for (char c : input)
+            count += c != '\n' && c != '\r';
+        break;
+    }
+    return count;
+}
+
+struct DayEntry
+{
+    int day;
+    ParseFunction parse;
+    SolveParsedFunction solveParsed;
+    InputUnit unit;
+    int version;                   // bump when the day's answers may change
+    StoreFunction store = nullptr; // both null for days without a binary cache
+    LoadFunction load = nullptr;
+
+    bool cacheable() const { return store != nullptr && load != nullptr; }
+
+    // Loads the parsed input from `cache` when given one that matches the
+    // input, parses the text otherwise
+    std::unique_ptr<ParsedInput> prepare(std::string_view input, int part, const CacheLocation *cache) const
+    {
+        if (cache != nullptr && cacheable())
+        {
+            CacheFile file(cache->path, day, cache->inputHash);
+            if (file.isOpen())
+            {
+                if (auto parsed = load(file))
+                    return parsed;
+            }
+        }
+        return parse(input, part);
+    }
+
+    // Parses the input once and writes its binary cache
+    bool writeCache(std::string_view input, const CacheLocation &cache) const
+    {
+        if (!cacheable())
+            return false;
+
+        auto parsed = parse(input, 1);
+        CacheWriter writer(day, cache.inputHash);
+        store(*parsed, writer);
+        return writer.write(cache.path);
+    }
+
+    ResultKey resultKey(std::string_view input, int part) const { return {day, part, version, xxh64(input)}; }
+
+    // Parses (or loads) and solves one part, timing each stage. With the
+    // result cache on, a known answer is returned from it instead; the lookup
+    // counts as the solve phase.
+    Answer solve(std::string_view input, int part, PhaseRecorder &phases, const CacheLocation *cache = nullptr) const
+    {
+        ResultCache &results = ResultCache::instance();
+        std::optional<ResultKey> key;
+        if (results.enabled())
+        {
+            auto known = phases.measure(Phase::SOLVE, [&]
+                                        {
+                key = resultKey(input, part);
+                return results.find(*key); });
+            if (known)
+                return *known;
+        }
+
+        auto parsed = phases.measure(Phase::PARSE, [&]
+                                     { return prepare(input, part, cache); });
+        Answer answer = phases.measure(Phase::SOLVE, [&]
+                                       { return solveParsed(*parsed, part); });
+        if (key)
+        {
+            results.store(*key, answer);
+            results.flush();
+        }
+        return answer;
+    }
+};
+
+} // namespace aoc
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace aoc
+{
+
+struct Summary
+{
+    double min = 0.0;
+    double median = 0.0;
+    double p99 = 0.0;
+    double mean = 0.0;
+};
+
+// Nearest-rank percentile of an already sorted sample, fraction in [0, 1]
+inline double percentile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+inline Summary summarize(std::vector<double> samples)
+{
+    Summary summary;
+    if (samples.empty())
+        return summary;
+
+    std::sort(samples.begin(), samples.end());
+    summary.min = samples.front();
+    summary.median = percentile(samples, 0.5);
+    summary.p99 = percentile(samples, 0.99);
+
+    double total = 0.0;
+    for (double sample : samples)
+        total += sample;
+    summary.mean = total / samples.size();
+    return summary;
+}
+
+struct LinearFit
+{
+    double slope = 0.0;
+    double intercept = 0.0;
+    double residual = 0.0; // root mean square of the residuals
+};
+
+// Ordinary least squares fit of y = slope * x + intercept
+inline LinearFit fitLine(const std::vector<double> &xs, const std::vector<double> &ys)
+{
+    LinearFit fit;
+    size_t count = std::min(xs.size(), ys.size());
+    if (count < 2)
+        return fit;
+
+    double meanX = 0.0, meanY = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        meanX += xs[i];
+        meanY += ys[i];
+    }
+    meanX /= count;
+    meanY /= count;
+
+    double covariance = 0.0, varianceX = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        covariance += (xs[i] - meanX) * (ys[i] - meanY);
+        varianceX += (xs[i] - meanX) * (xs[i] - meanX);
+    }
+    fit.slope = varianceX > 0.0 ? covariance / varianceX : 0.0;
+    fit.intercept = meanY - fit.slope * meanX;
+
+    double squares = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        double error = ys[i] - (fit.slope * xs[i] + fit.intercept);
+        squares += error * error;
+    }
+    fit.residual = std::sqrt(squares / count);
+    return fit;
+}
+
+// One-sided Mann-Whitney U test. Returns the p-value of the hypothesis that
+// samples in `later` tend to be larger than those in `earlier`, using the
+// normal approximation with tie and continuity corrections. Rank based, so a
+// few outliers (a page fault, a descheduled core) do not decide the outcome.
+inline double mannWhitneyGreater(const std::vector<double> &earlier, const std::vector<double> &later)
+{
+    size_t n1 = earlier.size(), n2 = later.size();
+    if (n1 == 0 || n2 == 0)
+        return 1.0;
+
+    std::vector<std::pair<double, bool>> pooled; // (value, from later)
+    pooled.reserve(n1 + n2);
+    for (double value : earlier)
+        pooled.emplace_back(value, false);
+    for (double value : later)
+        pooled.emplace_back(value, true);
+    std::sort(pooled.begin(), pooled.end());
+
+    // Sum of the (average) ranks of the later sample, ties sharing a rank
+    double rankSum = 0.0, tieTerm = 0.0;
+    for (size_t i = 0; i < pooled.size();)
+    {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first)
+            ++j;
+
+        double rank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; ++k)
+        {
+            if (pooled[k].second)
+                rankSum += rank;
+        }
+        double ties = static_cast<double>(j - i);
+        tieTerm += ties * ties * ties - ties;
+        i = j;
+    }
+
+    double total = static_cast<double>(n1 + n2);
+    double u = rankSum - n2 * (n2 + 1) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((total + 1.0) - tieTerm / (total * (total - 1.0)));
+    if (variance <= 0.0)
+        return 1.0;
+
+    double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+} // namespace aoc
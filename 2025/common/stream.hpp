@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <unistd.h>
+
+#include "common/pipeline.hpp"
+
+// Streaming mode for the days that can solve their input in one pass:
+//
+//   gen | day_01/main - [--chunk BYTES] [--every BYTES] [--part 1|2]
+//
+// Input is read from stdin in chunks of whole lines and never held in full;
+// at most a pipeline window of chunks is buffered at a time. With --every
+// the day prints its running totals each time that many more bytes have been
+// folded, so long-running producers show progress.
+
+namespace aoc
+{
+
+struct StreamOptions
+{
+    bool enabled = false; // first argument was "-"
+    bool valid = true;
+    size_t chunkBytes = ChunkSource::DEFAULT_CHUNK_BYTES;
+    size_t reportBytes = 0U; // 0: totals only at the end
+    int part = 0;            // 0: every part the day can stream
+};
+
+inline StreamOptions parseStreamOptions(int argc, char **argv)
+{
+    StreamOptions options;
+    if (argc < 2 || std::string_view(argv[1]) != "-")
+        return options;
+
+    options.enabled = true;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Error: " << (arg.starts_with("--") ? "option needs a value: " : "unknown argument: ") << arg << std::endl;
+            options.valid = false;
+            break;
+        }
+
+        long value = std::atol(argv[++i]);
+        if (arg == "--chunk" && value > 0)
+            options.chunkBytes = static_cast<size_t>(value);
+        else if (arg == "--every" && value >= 0)
+            options.reportBytes = static_cast<size_t>(value);
+        else if (arg == "--part" && (value == 1 || value == 2))
+            options.part = static_cast<int>(value);
+        else
+        {
+            std::cerr << "Error: invalid argument " << arg << " " << argv[i] << std::endl;
+            options.valid = false;
+            break;
+        }
+    }
+
+    if (!options.valid)
+        std::cerr << "Usage: " << argv[0] << " - [--chunk BYTES] [--every BYTES] [--part 1|2]" << std::endl;
+    return options;
+}
+
+inline bool streamsPart(const StreamOptions &options, int part)
+{
+    return options.part == 0 || options.part == part;
+}
+
+// Calls report(bytes) whenever another options.reportBytes bytes of input
+// have been folded
+class ProgressReporter
+{
+public:
+    explicit ProgressReporter(size_t reportBytes) : reportBytes_(reportBytes) {}
+
+    template <typename Report>
+    void advance(size_t bytes, Report &&report)
+    {
+        folded_ += bytes;
+        if (reportBytes_ == 0U || folded_ < nextReport_ + reportBytes_)
+            return;
+
+        nextReport_ = folded_ - folded_ % reportBytes_;
+        report(folded_);
+    }
+
+    size_t folded() const { return folded_; }
+
+private:
+    size_t reportBytes_;
+    size_t folded_ = 0U;
+    size_t nextReport_ = 0U;
+};
+
+// runPipeline over `source` that additionally reports running totals:
+// report(bytes) runs on the calling thread right after the chunk that crossed
+// an interval was folded
+template <typename Process, typename Fold, typename Report>
+size_t runStreaming(ChunkSource &source, const StreamOptions &options, Process &&process, Fold &&fold, Report &&report)
+{
+    ProgressReporter progress(options.reportBytes);
+    runPipeline(
+        source, [&process](std::string_view chunk)
+        { return std::make_pair(process(chunk), chunk.size()); },
+        [&](auto &&result)
+        {
+            fold(std::move(result.first));
+            progress.advance(result.second, report);
+        });
+    return progress.folded();
+}
+
+} // namespace aoc
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Shared work-stealing pool for the solvers.
+//
+// Every worker owns a deque: tasks it spawns go to the back and it pops them
+// from the back, while idle workers steal from the front of the others. Tasks
+// from threads outside the pool land in a shared injection queue. A thread
+// waiting on a TaskGroup runs queued tasks instead of blocking, so groups can
+// be nested (a day running inside a pool task may itself use parallelFor).
+//
+// parallelFor and parallelReduce cut a range into chunks whose boundaries
+// depend only on the range and the grain, never on the thread count, and
+// parallelReduce folds the per-chunk results in chunk order. The result of a
+// reduction is therefore the same on 1 or 64 threads, even for operations
+// that are not associative.
+//
+// The pool size defaults to the hardware concurrency and can be set with
+// AOC_THREADS or ThreadPool::configure() before first use.
+
+namespace aoc
+{
+
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    // Total threads working on tasks, counting the one that waits
+    explicit ThreadPool(size_t threads) : queues_(std::max<size_t>(threads, 1U))
+    {
+        for (size_t i = 1; i < queues_.size(); ++i)
+            workers_.emplace_back([this, i]
+                                  { workerLoop(i); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+        sleep_.notify_all();
+        for (auto &worker : workers_)
+            worker.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Sets the size of the shared pool; only effective before instance()
+    static void configure(size_t threads) { requestedThreads() = threads; }
+
+    static ThreadPool &instance()
+    {
+        static ThreadPool pool(defaultThreadCount());
+        return pool;
+    }
+
+    size_t size() const { return queues_.size(); }
+
+    void submit(Task task)
+    {
+        // Queue 0 is the injection queue for threads outside the pool
+        size_t index = currentIndex() > 0U && owner() == this ? currentIndex() : 0U;
+        // Counted before it is visible, so a thief's decrement never takes
+        // queued_ below the number of tasks actually queued
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            ++queued_;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[index].mutex);
+            queues_[index].tasks.push_back(std::move(task));
+        }
+        sleep_.notify_one();
+    }
+
+    // Runs one queued task on the calling thread. Returns false if there was
+    // nothing to run.
+    bool runOne()
+    {
+        size_t self = owner() == this ? currentIndex() : 0U;
+        Task task;
+        if (!popBack(self, task) && !popFront(0U, task))
+        {
+            bool stolen = false;
+            for (size_t offset = 1; offset < queues_.size() && !stolen; ++offset)
+                stolen = popFront((self + offset) % queues_.size(), task);
+            if (!stolen)
+                return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            --queued_;
+        }
+        task();
+        return true;
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    static size_t &requestedThreads()
+    {
+        static size_t threads = 0U;
+        return threads;
+    }
+
+    static size_t defaultThreadCount()
+    {
+        if (requestedThreads() > 0U)
+            return requestedThreads();
+        if (const char *threads = std::getenv("AOC_THREADS"))
+        {
+            int count = std::atoi(threads);
+            if (count > 0)
+                return static_cast<size_t>(count);
+        }
+        return std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // Which pool the current thread works for, and its queue there
+    static ThreadPool *&owner()
+    {
+        thread_local ThreadPool *pool = nullptr;
+        return pool;
+    }
+
+    static size_t &currentIndex()
+    {
+        thread_local size_t index = 0U;
+        return index;
+    }
+
+    bool popBack(size_t index, Task &task)
+    {
+        std::lock_guard<std::mutex> lock(queues_[index].mutex);
+        if (queues_[index].tasks.empty())
+            return false;
+        task = std::move(queues_[index].tasks.back());
+        queues_[index].tasks.pop_back();
+        return true;
+    }
+
+    bool popFront(size_t index, Task &task)
+    {
+        std::lock_guard<std::mutex> lock(queues_[index].mutex);
+        if (queues_[index].tasks.empty())
+            return false;
+        task = std::move(queues_[index].tasks.front());
+        queues_[index].tasks.pop_front();
+        return true;
+    }
+
+    void workerLoop(size_t index)
+    {
+        owner() = this;
+        currentIndex() = index;
+        for (;;)
+        {
+            if (runOne())
+                continue;
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            sleep_.wait(lock, [this]
+                        { return stop_ || queued_ > 0U; });
+            if (stop_)
+                return;
+        }
+    }
+
+    std::vector<Queue> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleepMutex_;
+    std::condition_variable sleep_;
+    size_t queued_ = 0U;
+    bool stop_ = false;
+};
+
+// A set of tasks that can be waited for together. The waiting thread helps
+// run queued work; the first exception thrown by a task is rethrown by wait().
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool &pool = ThreadPool::instance()) : pool_(pool) {}
+
+    ~TaskGroup()
+    {
+        // Tasks reference the group, so it cannot go away before they finish
+        while (pending_.load(std::memory_order_acquire) > 0U)
+            helpOrSleep();
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    template <typename Work>
+    void run(Work &&work)
+    {
+        pending_.fetch_add(1U, std::memory_order_relaxed);
+        pool_.submit([this, work = std::forward<Work>(work)]() mutable
+                     {
+            try
+            {
+                work();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+            finish(); });
+    }
+
+    void wait()
+    {
+        while (pending_.load(std::memory_order_acquire) > 0U)
+            helpOrSleep();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+private:
+    void finish()
+    {
+        // Decrement under the lock: once a waiter has seen zero and taken the
+        // lock, this task no longer touches the group
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+            done_.notify_all();
+    }
+
+    void helpOrSleep()
+    {
+        if (pool_.runOne())
+            return;
+
+        // Our remaining tasks run elsewhere; nap briefly in case new work
+        // shows up that we could help with
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait_for(lock, std::chrono::microseconds(200), [this]
+                       { return pending_.load(std::memory_order_acquire) == 0U; });
+    }
+
+    ThreadPool &pool_;
+    std::atomic<size_t> pending_ = 0U;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::exception_ptr error_;
+};
+
+namespace detail
+{
+
+// Upper bound on the chunks a range is cut into when no grain is given
+constexpr size_t MAX_CHUNKS = 1024U;
+
+inline size_t chunkSize(size_t count, size_t grain)
+{
+    if (grain > 0U)
+        return grain;
+    return std::max<size_t>(1U, (count + MAX_CHUNKS - 1U) / MAX_CHUNKS);
+}
+
+} // namespace detail
+
+// Calls body(i) for every i in [begin, end). grain is the number of indices
+// per task; 0 picks one so there are at most MAX_CHUNKS tasks. Use a small
+// grain when iterations vary a lot in cost so stealing can even them out.
+template <typename Body>
+void parallelFor(size_t begin, size_t end, Body &&body, size_t grain = 0U, ThreadPool &pool = ThreadPool::instance())
+{
+    if (begin >= end)
+        return;
+
+    size_t chunk = detail::chunkSize(end - begin, grain);
+    if (pool.size() == 1U || chunk >= end - begin)
+    {
+        for (size_t i = begin; i < end; ++i)
+            body(i);
+        return;
+    }
+
+    TaskGroup group(pool);
+    for (size_t first = begin; first < end; first += chunk)
+    {
+        size_t last = std::min(end, first + chunk);
+        group.run([&body, first, last]
+                  {
+            for (size_t i = first; i < last; ++i)
+                body(i); });
+    }
+    group.wait();
+}
+
+// Folds map(i) for i in [begin, end) with combine, starting each chunk from
+// identity and then combining the chunk results in index order.
+template <typename T, typename Map, typename Combine>
+T parallelReduce(size_t begin, size_t end, T identity, Map &&map, Combine &&combine, size_t grain = 0U,
+                 ThreadPool &pool = ThreadPool::instance())
+{
+    if (begin >= end)
+        return identity;
+
+    size_t chunk = detail::chunkSize(end - begin, grain);
+    size_t chunkCount = (end - begin + chunk - 1U) / chunk;
+    std::vector<T> partials(chunkCount, identity);
+    auto reduceChunk = [&](size_t index)
+    {
+        size_t first = begin + index * chunk;
+        size_t last = std::min(end, first + chunk);
+        T accumulator = identity;
+        for (size_t i = first; i < last; ++i)
+            accumulator = combine(std::move(accumulator), map(i));
+        partials[index] = std::move(accumulator);
+    };
+    parallelFor(0U, chunkCount, reduceChunk, 1U, pool);
+
+    T result = std::move(identity);
+    for (auto &partial : partials)
+        result = combine(std::move(result), std::move(partial));
+    return result;
+}
+
+} // namespace aoc
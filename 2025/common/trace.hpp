@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+// Diagnostics for solver inner loops. Tracing is gated twice:
+//
+//  * at compile time by AOC_TRACE_LEVEL (0 = off, the default). Statements
+//    above that level are discarded by `if constexpr` and generate no code;
+//  * at run time by opening a sink, either with aoc::trace::openFile() or by
+//    setting AOC_TRACE_FILE. Until then a compiled-in trace costs one branch.
+//
+// Messages are formatted per thread and appended to a large buffered file, so
+// even enabled tracing never flushes a terminal from inside a solver loop.
+//
+//   AOC_TRACE(aoc::TraceLevel::DEBUG, "Read " << first << "-" << second);
+
+#ifndef AOC_TRACE_LEVEL
+#define AOC_TRACE_LEVEL 0
+#endif
+
+namespace aoc
+{
+
+enum class TraceLevel : int
+{
+    INFO = 1,    // a few lines per run
+    DEBUG = 2,   // one line per input record
+    VERBOSE = 3, // one line per inner-loop step
+};
+
+namespace trace
+{
+
+constexpr bool compiledIn(TraceLevel level)
+{
+    return static_cast<int>(level) <= AOC_TRACE_LEVEL;
+}
+
+class Sink
+{
+public:
+    static Sink &instance()
+    {
+        static Sink sink;
+        return sink;
+    }
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    bool openFile(std::string const &path)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_.reset();
+        enabled_ = false;
+
+        auto file = std::make_unique<std::ofstream>();
+        file->rdbuf()->pubsetbuf(buffer_.get(), BUFFER_SIZE);
+        file->open(path, std::ios::out | std::ios::trunc);
+        if (!file->is_open())
+            return false;
+
+        file_ = std::move(file);
+        enabled_ = true;
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        enabled_ = false;
+        file_.reset();
+    }
+
+    void write(std::string const &message)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (file_)
+            *file_ << message << '\n';
+    }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+    Sink() : buffer_(std::make_unique<char[]>(BUFFER_SIZE))
+    {
+        if (const char *path = std::getenv("AOC_TRACE_FILE"))
+            openFile(path);
+    }
+
+    std::unique_ptr<char[]> buffer_;
+    std::unique_ptr<std::ofstream> file_;
+    std::mutex mutex_;
+    std::atomic<bool> enabled_ = false;
+};
+
+inline bool enabled()
+{
+    return Sink::instance().enabled();
+}
+
+inline bool openFile(std::string const &path)
+{
+    return Sink::instance().openFile(path);
+}
+
+inline void close()
+{
+    Sink::instance().close();
+}
+
+// Per-thread scratch stream so formatting never happens under the sink lock
+inline std::ostringstream &scratch()
+{
+    thread_local std::ostringstream stream;
+    stream.str(std::string());
+    return stream;
+}
+
+} // namespace trace
+} // namespace aoc
+
+// True when a statement at this level is compiled in and a sink is open. Use
+// it to skip work that only exists to build a trace message.
+#define AOC_TRACE_ON(level) (aoc::trace::compiledIn(level) && aoc::trace::enabled())
+
+#define AOC_TRACE(level, message)                                        \
+    do                                                                   \
+    {                                                                    \
+        if constexpr (aoc::trace::compiledIn(level))                     \
+        {                                                                \
+            if (aoc::trace::enabled())                                   \
+            {                                                            \
+                auto &aocTraceStream = aoc::trace::scratch();            \
+                aocTraceStream << message;                               \
+                aoc::trace::Sink::instance().write(aocTraceStream.str()); \
+            }                                                            \
+        }                                                                \
+    } while (0)
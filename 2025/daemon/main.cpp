@@ -0,0 +1,396 @@
+// aocd: solve daemon serving the day library over a Unix domain socket.
+//
+//   ./aocd --socket PATH [--threads N] [--results PATH]
+//   ./aocd --socket PATH --solve DAY INPUT [--repeat R]
+//
+// The first form serves requests until killed. The thread pool, the result
+// cache and a pooled upstream for the parse arenas live as long as the
+// daemon, so a request pays for parsing and solving only, not for process
+// start-up and cold caches. The second form is a client: it sends INPUT R
+// times and prints the answers and latencies.
+//
+// Protocol, one request after another on a connection:
+//
+//   SOLVE <day> <bytes>\n<bytes of input>   ->  OK <part1> <part2> <latency us>\n
+//   STATS\n                                 ->  OK <requests> <min>/<median>/<p99> us\n
+//
+// Errors are answered with "ERR <message>\n". Latency is measured from the
+// moment the input has been received to the moment the answer is ready.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "common/input_reader.hpp"
+#include "common/result_cache.hpp"
+#include "common/stats.hpp"
+#include "common/thread_pool.hpp"
+#include "runner/library.hpp"
+
+namespace
+{
+
+// Largest input a request may carry
+constexpr size_t MAX_REQUEST_BYTES = 256U << 20;
+
+// Arena blocks up to this size are recycled between requests instead of
+// going back to the heap
+constexpr size_t POOLED_BLOCK_BYTES = 16U << 20;
+
+struct Options
+{
+    std::string socketPath;
+    size_t threads = 0U;
+    std::string resultsPath;
+    int solveDay = 0;
+    std::string inputPath;
+    int repeat = 1;
+};
+
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " --socket PATH [--threads N] [--results PATH]\n"
+              << "       " << program << " --socket PATH --solve DAY INPUT [--repeat R]" << std::endl;
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: " << arg << " needs a value" << std::endl;
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--socket")
+            options.socketPath = value();
+        else if (arg == "--threads")
+            options.threads = std::max(1, std::atoi(value().c_str()));
+        else if (arg == "--results")
+            options.resultsPath = value();
+        else if (arg == "--solve")
+        {
+            options.solveDay = std::atoi(value().c_str());
+            options.inputPath = value();
+        }
+        else if (arg == "--repeat")
+            options.repeat = std::max(1, std::atoi(value().c_str()));
+        else if (arg == "--help" || arg == "-h")
+        {
+            printUsage(argv[0]);
+            std::exit(0);
+        }
+        else
+        {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.socketPath.empty())
+    {
+        std::cerr << "Error: --socket is required" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool writeAll(int fd, std::string_view data)
+{
+    while (!data.empty())
+    {
+        ssize_t written = ::write(fd, data.data(), data.size());
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+    return true;
+}
+
+// Buffered reads from a connection: a header line, then an exact byte count
+class Connection
+{
+public:
+    explicit Connection(int fd) : fd_(fd) {}
+
+    ~Connection() { ::close(fd_); }
+
+    Connection(const Connection &) = delete;
+    Connection &operator=(const Connection &) = delete;
+
+    int fd() const { return fd_; }
+
+    bool readLine(std::string &line)
+    {
+        size_t newline;
+        while ((newline = buffer_.find('\n')) == std::string::npos)
+        {
+            if (buffer_.size() > 4096U || !fill())
+                return false;
+        }
+        line.assign(buffer_, 0, newline);
+        buffer_.erase(0, newline + 1U);
+        return true;
+    }
+
+    bool readExact(size_t bytes, std::string &data)
+    {
+        while (buffer_.size() < bytes)
+        {
+            if (!fill())
+                return false;
+        }
+        data.assign(buffer_, 0, bytes);
+        buffer_.erase(0, bytes);
+        return true;
+    }
+
+private:
+    bool fill()
+    {
+        char chunk[1 << 16];
+        ssize_t bytesRead = aoc::readRetrying(fd_, chunk, sizeof(chunk));
+        if (bytesRead <= 0)
+            return false;
+        buffer_.append(chunk, static_cast<size_t>(bytesRead));
+        return true;
+    }
+
+    int fd_;
+    std::string buffer_;
+};
+
+// Request latencies since start-up, shared by all connections
+class LatencyLog
+{
+public:
+    void add(double microseconds)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        samples_.push_back(microseconds);
+    }
+
+    std::string report()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aoc::Summary summary = aoc::summarize(samples_);
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << "OK " << samples_.size() << " " << summary.min << "/"
+             << summary.median << "/" << summary.p99 << " us\n";
+        return text.str();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<double> samples_;
+};
+
+void serveConnection(int fd, LatencyLog &latencies)
+{
+    Connection connection(fd);
+    std::string line, input;
+    while (connection.readLine(line))
+    {
+        std::istringstream header(line);
+        std::string command;
+        header >> command;
+
+        if (command == "STATS")
+        {
+            if (!writeAll(fd, latencies.report()))
+                return;
+            continue;
+        }
+
+        int day = 0;
+        size_t bytes = 0U;
+        if (command != "SOLVE" || !(header >> day >> bytes))
+        {
+            writeAll(fd, "ERR malformed request\n");
+            return;
+        }
+        if (bytes > MAX_REQUEST_BYTES)
+        {
+            writeAll(fd, "ERR input too large\n");
+            return;
+        }
+        if (!connection.readExact(bytes, input))
+            return;
+
+        auto start = std::chrono::steady_clock::now();
+        std::string response;
+        try
+        {
+            auto results = aoc::solveDay(day, input);
+            double latency = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            if (results)
+            {
+                latencies.add(latency);
+                std::ostringstream text;
+                text << "OK " << results->part1 << " " << results->part2 << " " << std::fixed << std::setprecision(1) << latency << "\n";
+                response = text.str();
+            }
+            else
+                response = "ERR no solver for day " + std::to_string(day) + "\n";
+        }
+        catch (const std::exception &error)
+        {
+            response = std::string("ERR ") + error.what() + "\n";
+        }
+
+        if (!writeAll(fd, response))
+            return;
+    }
+}
+
+int connectTo(const std::string &socketPath)
+{
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1U);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        std::cerr << "Error: Could not connect to " << socketPath << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0)
+            ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int runServer(const Options &options)
+{
+    if (options.socketPath.size() >= sizeof(sockaddr_un::sun_path))
+    {
+        std::cerr << "Error: socket path too long: " << options.socketPath << std::endl;
+        return 1;
+    }
+
+    // Warm state for the daemon's lifetime: the pool, the result cache and
+    // the arena upstream (arenas draw their blocks from the default resource)
+    if (options.threads > 0U)
+        aoc::ThreadPool::configure(options.threads);
+    if (!options.resultsPath.empty())
+        aoc::ResultCache::configure(options.resultsPath);
+    aoc::ThreadPool::instance();
+    aoc::ResultCache::instance();
+    static std::pmr::synchronized_pool_resource arenaBlocks(std::pmr::pool_options{0U, POOLED_BLOCK_BYTES});
+    std::pmr::set_default_resource(&arenaBlocks);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1U);
+    ::unlink(options.socketPath.c_str());
+    if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, SOMAXCONN) != 0)
+    {
+        std::cerr << "Error: Could not listen on " << options.socketPath << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::cerr << "aocd: listening on " << options.socketPath << " with " << aoc::ThreadPool::instance().size()
+              << " threads" << std::endl;
+    LatencyLog latencies;
+    for (;;)
+    {
+        int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        std::thread(serveConnection, fd, std::ref(latencies)).detach();
+    }
+}
+
+int runClient(const Options &options)
+{
+    aoc::InputFile file(options.inputPath);
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open file " << options.inputPath << std::endl;
+        return 1;
+    }
+
+    int fd = connectTo(options.socketPath);
+    if (fd < 0)
+        return 1;
+    Connection connection(fd);
+
+    std::string request = "SOLVE " + std::to_string(options.solveDay) + " " + std::to_string(file.contents().size()) + "\n";
+    std::string response;
+    std::vector<double> roundTrips;
+    for (int r = 0; r < options.repeat; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!writeAll(fd, request) || !writeAll(fd, file.contents()) || !connection.readLine(response))
+        {
+            std::cerr << "Error: connection to " << options.socketPath << " lost" << std::endl;
+            return 1;
+        }
+        roundTrips.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        if (response.rfind("OK", 0) != 0)
+        {
+            std::cerr << "Error: " << (response.rfind("ERR ", 0) == 0 ? response.substr(4) : response) << std::endl;
+            return 1;
+        }
+    }
+
+    // OK <part1> <part2> <latency>
+    std::istringstream fields(response.substr(3));
+    aoc::Answer part1 = 0, part2 = 0;
+    fields >> part1 >> part2;
+    aoc::Summary summary = aoc::summarize(roundTrips);
+    std::cout << "Part 1: " << part1 << "\nPart 2: " << part2 << "\n"
+              << std::fixed << std::setprecision(1) << "round trip over " << options.repeat << " requests: "
+              << summary.min << "/" << summary.median << "/" << summary.p99 << " us (min/median/p99)" << std::endl;
+
+    if (!writeAll(fd, "STATS\n") || !connection.readLine(response))
+        return 1;
+    std::cout << "daemon latency: " << response.substr(3) << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    return options.solveDay > 0 ? runClient(options) : runServer(options);
+}
@@ -1,7 +1,32 @@
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "common/cpu_dispatch.hpp"
+#include "common/fast_divisor.hpp"
+#include "common/input_reader.hpp"
+#include "common/parse.hpp"
+#include "common/pipeline.hpp"
+#include "common/solver.hpp"
+#include "common/stream.hpp"
+#include "common/thread_pool.hpp"
+#include "common/trace.hpp"
+
+namespace day01
+{
+
+constexpr int DIAL_SIZE = 100;
 constexpr int INITIAL_DIAL_POSITION = 50;
 
 enum class EvaluationStrategy : uint8_t
@@ -10,10 +35,11 @@ enum class EvaluationStrategy : uint8_t
     CROSSING_AND_LANDING // Part 2
 };
 
-int parseRotationValue(std::string const &line)
+int parseRotationValue(std::string_view line)
 {
     char direction = line[0];
-    int rotationValue = std::stoi(line.substr(1));
+    int rotationValue = 0;
+    aoc::parseUnsigned(line.data() + 1, line.data() + line.size(), rotationValue);
 
     if (direction == 'L')
     {
@@ -22,82 +48,689 @@ int parseRotationValue(std::string const &line)
     return rotationValue;
 }
 
-// processes the rotation, calculate the new dial position and number of times
-// it hits position 0 according to the evaluation method
-std::pair<int, int> processRotation(int currentPosition, int rotationValue, EvaluationStrategy method)
+// Dial with a size fixed at compile time, so divisions by it strength-reduce
+template <uint32_t SIZE>
+struct FixedDial
+{
+    static constexpr uint32_t size() { return SIZE; }
+    static constexpr uint32_t divide(uint32_t value) { return value / SIZE; }
+};
+
+// Dial with a size chosen at run time, divided by multiplication
+class RuntimeDial
+{
+public:
+    explicit RuntimeDial(uint32_t size) : divisor_(size) {}
+
+    uint32_t size() const { return divisor_.divisor(); }
+    uint32_t divide(uint32_t value) const { return divisor_.divide(value); }
+
+private:
+    aoc::FastDivisor divisor_;
+};
+
+// What one rotation does to the dial
+struct RotationStep
+{
+    uint32_t nextPosition;
+    bool landed;        // ends on 0
+    uint32_t crossings; // times it passes or ends on 0
+};
+
+// Applies a rotation to the dial at `position`. Whole turns pass 0 whatever
+// the position; the partial turn passes it going right from positions
+// >= size - partial and going left from 1..partial.
+template <typename Dial>
+AOC_ALWAYS_INLINE RotationStep applyRotation(const Dial &dial, uint32_t position, int rotationValue)
 {
-    int nextPosition = currentPosition + rotationValue;
-    int correctedNextPosition = (nextPosition % 100 + 100) % 100; // wrap around 0-99;
-    int zeroHits = 0;
+    uint32_t distance = rotationValue < 0 ? 0U - static_cast<uint32_t>(rotationValue) : static_cast<uint32_t>(rotationValue);
+    uint32_t wholeTurns = dial.divide(distance);
+    uint32_t partial = distance - wholeTurns * dial.size();
 
-    if (method == EvaluationStrategy::ONLY_LANDING)
+    uint32_t nextPosition;
+    bool crossed;
+    if (rotationValue >= 0)
     {
-        if (correctedNextPosition == 0)
-            zeroHits = 1;
+        nextPosition = position + partial;
+        crossed = nextPosition >= dial.size();
+        nextPosition -= crossed ? dial.size() : 0U;
     }
-    else if (method == EvaluationStrategy::CROSSING_AND_LANDING)
+    else
     {
-        auto mapToCycle = [](int pos) -> int
-        {
-            return pos >= 0 ? (pos / 100) : (pos / 100) - 1;
-        };
+        crossed = position > 0U && position <= partial;
+        nextPosition = position >= partial ? position - partial : position + dial.size() - partial;
+    }
+    return {nextPosition, nextPosition == 0U, wholeTurns + crossed};
+}
+
+template <EvaluationStrategy STRATEGY>
+constexpr uint32_t zeroHits(const RotationStep &step)
+{
+    if constexpr (STRATEGY == EvaluationStrategy::ONLY_LANDING)
+        return step.landed;
+    else
+        return step.crossings;
+}
+
+// Counts the zero hits of every strategy in STRATEGIES (in that order) in one
+// walk over the rotations; the strategies are resolved at compile time, so
+// the loop carries no per-rotation branch on them
+template <EvaluationStrategy... STRATEGIES, typename Dial>
+std::array<int64_t, sizeof...(STRATEGIES)> evaluateRotations(std::span<const int> rotations, const Dial &dial, uint32_t initialPosition)
+{
+    std::array<int64_t, sizeof...(STRATEGIES)> hits{};
+    uint32_t position = initialPosition;
+    for (int rotationValue : rotations)
+    {
+        RotationStep step = applyRotation(dial, position, rotationValue);
+        AOC_TRACE(aoc::TraceLevel::VERBOSE, "From " << position << " to " << step.nextPosition << " crosses 0 for " << step.crossings << " times.");
+        size_t index = 0;
+        ((hits[index++] += zeroHits<STRATEGIES>(step)), ...);
+        position = step.nextPosition;
+    }
+    return hits;
+}
+
+// Effect of a run of rotations on both zero counts, for every position the
+// dial could be at when the run starts. Segments compose associatively, so
+// chunks of the input can be summarized independently and folded in order.
+class DialSegment
+{
+public:
+    int displacement = 0;                          // net movement, mod DIAL_SIZE
+    std::array<int64_t, DIAL_SIZE> landingHits{};  // part 1 count per start position
+    std::array<int64_t, DIAL_SIZE> crossingHits{}; // part 2 count per start position
 
-        if (rotationValue >= 0)
+    // Appends the segment that follows this one
+    void append(const DialSegment &next)
+    {
+        for (int start = 0; start < DIAL_SIZE; ++start)
         {
-            // example: 50 -> 150
-            zeroHits = mapToCycle(nextPosition);
+            int shifted = (start + displacement) % DIAL_SIZE;
+            landingHits[start] += next.landingHits[shifted];
+            crossingHits[start] += next.crossingHits[shifted];
         }
-        else
-        {
-            // example: 50 -> -60
-            zeroHits = mapToCycle(currentPosition - 1) - mapToCycle(nextPosition);
+        displacement = (displacement + next.displacement) % DIAL_SIZE;
+    }
+
+    int64_t zeroHits(int startPosition, EvaluationStrategy method) const
+    {
+        return method == EvaluationStrategy::ONLY_LANDING ? landingHits[startPosition] : crossingHits[startPosition];
+    }
+};
+
+// Position in [0, DIAL_SIZE) of an unwrapped position of either sign
+inline int wrapPosition(int position)
+{
+    int remainder = position % DIAL_SIZE;
+    return remainder < 0 ? remainder + DIAL_SIZE : remainder;
+}
+
+// Rotations handed to the block kernel at a time
+constexpr size_t ROTATION_BLOCK = 1024U;
+
+// Where the rotations of a block hit zero, relative to the start of the run
+// they belong to. With the dial at p before a rotation (p counted from the
+// run's start), the rotation lands on zero for a run started at
+// landing[i], and its partial turn crosses zero for the crossingLength[i]
+// start positions from crossingFirst[i] on, wrapping. Whole turns cross zero
+// whatever the start. startPosition is p before the block; returns p after.
+template <size_t VECTOR_BYTES>
+AOC_ALWAYS_INLINE int locateZeroHitsBody(const int *rotations, size_t count, int startPosition, int *landing,
+                                         int *crossingFirst, int *crossingLength, int64_t &wholeTurns)
+{
+    using Vector = aoc::cpu::Vector<int, VECTOR_BYTES>;
+    constexpr size_t LANES = VECTOR_BYTES / sizeof(int);
+
+    // Partial turns, signed like the rotation, into crossingLength
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES)
+    {
+        Vector rotation;
+        std::memcpy(&rotation, rotations + i, VECTOR_BYTES);
+        Vector partial = rotation % DIAL_SIZE;
+        std::memcpy(crossingLength + i, &partial, VECTOR_BYTES);
+    }
+    for (; i < count; ++i)
+    {
+        crossingLength[i] = rotations[i] % DIAL_SIZE;
+    }
+
+    // The only sequential step: unwrapped positions after each rotation, into
+    // landing. A block moves the dial by less than ROTATION_BLOCK turns.
+    int position = startPosition;
+    int64_t turnDistance = 0;
+    for (i = 0; i < count; ++i)
+    {
+        int partial = crossingLength[i];
+        position += partial;
+        landing[i] = position;
+        turnDistance += std::abs(static_cast<int64_t>(rotations[i])) - std::abs(partial);
+    }
+    wholeTurns += turnDistance / DIAL_SIZE;
+
+    // Going right from p crosses zero for shifted positions >= 100 - partial,
+    // going left for 1 <= p <= partial
+    for (i = 0; i + LANES <= count; i += LANES)
+    {
+        Vector unwrapped, partial;
+        std::memcpy(&unwrapped, landing + i, VECTOR_BYTES);
+        std::memcpy(&partial, crossingLength + i, VECTOR_BYTES);
+        Vector after = unwrapped % DIAL_SIZE;
+        after = after < 0 ? after + DIAL_SIZE : after;
+        Vector before = (unwrapped - partial) % DIAL_SIZE;
+        before = before < 0 ? before + DIAL_SIZE : before;
+        Vector length = partial < 0 ? -partial : partial;
+        Vector firstPosition = partial > 0 ? DIAL_SIZE - partial : Vector{} + 1;
+        Vector first = firstPosition - before;
+        first = first < 0 ? first + DIAL_SIZE : first;
+        Vector zero = after == 0 ? Vector{} : DIAL_SIZE - after;
+        std::memcpy(landing + i, &zero, VECTOR_BYTES);
+        std::memcpy(crossingFirst + i, &first, VECTOR_BYTES);
+        std::memcpy(crossingLength + i, &length, VECTOR_BYTES);
+    }
+    for (; i < count; ++i)
+    {
+        int partial = crossingLength[i];
+        int after = wrapPosition(landing[i]);
+        int before = wrapPosition(landing[i] - partial);
+        int first = (partial > 0 ? DIAL_SIZE - partial : 1) - before;
+        landing[i] = after == 0 ? 0 : DIAL_SIZE - after;
+        crossingFirst[i] = first < 0 ? first + DIAL_SIZE : first;
+        crossingLength[i] = std::abs(partial);
+    }
 
-            if (nextPosition == 0)
+    return wrapPosition(position);
+}
+
+using LocateZeroHitsKernel = int (*)(const int *, size_t, int, int *, int *, int *, int64_t &);
+
+int locateZeroHitsBaseline(const int *rotations, size_t count, int startPosition, int *landing, int *crossingFirst,
+                           int *crossingLength, int64_t &wholeTurns)
+{
+    return locateZeroHitsBody<aoc::cpu::BASELINE_VECTOR_BYTES>(rotations, count, startPosition, landing, crossingFirst,
+                                                               crossingLength, wholeTurns);
+}
+
+AOC_TARGET_SSE42 int locateZeroHitsSse42(const int *rotations, size_t count, int startPosition, int *landing,
+                                         int *crossingFirst, int *crossingLength, int64_t &wholeTurns)
+{
+    return locateZeroHitsBody<aoc::cpu::SSE42_VECTOR_BYTES>(rotations, count, startPosition, landing, crossingFirst,
+                                                            crossingLength, wholeTurns);
+}
+
+AOC_TARGET_AVX2 int locateZeroHitsAvx2(const int *rotations, size_t count, int startPosition, int *landing,
+                                       int *crossingFirst, int *crossingLength, int64_t &wholeTurns)
+{
+    return locateZeroHitsBody<aoc::cpu::AVX2_VECTOR_BYTES>(rotations, count, startPosition, landing, crossingFirst,
+                                                           crossingLength, wholeTurns);
+}
+
+AOC_TARGET_AVX512 int locateZeroHitsAvx512(const int *rotations, size_t count, int startPosition, int *landing,
+                                           int *crossingFirst, int *crossingLength, int64_t &wholeTurns)
+{
+    return locateZeroHitsBody<aoc::cpu::AVX512_VECTOR_BYTES>(rotations, count, startPosition, landing, crossingFirst,
+                                                             crossingLength, wholeTurns);
+}
+
+// Builds the DialSegment of a run of rotations, fed in any number of pieces.
+// The run is walked once from position 0; started from s instead, every
+// position is shifted by s, so a landing on p is a zero for s = -p and each
+// partial turn crosses zero for a contiguous, wrapping range of s, recorded
+// in a difference array.
+class SegmentBuilder
+{
+public:
+    SegmentBuilder()
+        : locateZeroHits_(aoc::cpu::select<LocateZeroHitsKernel>(locateZeroHitsBaseline, locateZeroHitsSse42,
+                                                                 locateZeroHitsAvx2, locateZeroHitsAvx512))
+    {
+    }
+
+    void add(std::span<const int> rotations)
+    {
+        std::array<int, ROTATION_BLOCK> landing, crossingFirst, crossingLength;
+        for (size_t offset = 0; offset < rotations.size(); offset += ROTATION_BLOCK)
+        {
+            size_t count = std::min(ROTATION_BLOCK, rotations.size() - offset);
+            position_ = locateZeroHits_(rotations.data() + offset, count, position_, landing.data(), crossingFirst.data(),
+                                        crossingLength.data(), wholeTurns_);
+            for (size_t i = 0; i < count; ++i)
             {
-                // Special case: landing exactly on 0 when going negative
-                zeroHits += 1;
+                segment_.landingHits[landing[i]]++;
+                // Unwrapped range; an empty one adds and removes at one index
+                crossingDelta_[crossingFirst[i]]++;
+                crossingDelta_[crossingFirst[i] + crossingLength[i]]--;
             }
         }
     }
-    // std::cout << "From " << currentPosition << " to " << correctedNextPosition << " [" << nextPosition << "] crosses 0 for " << zeroHits << " times." << std::endl;
-    return {correctedNextPosition, zeroHits};
+
+    DialSegment finish()
+    {
+        // A range running past the last position continues at position 0
+        std::array<int64_t, 2 * DIAL_SIZE> covered{};
+        int64_t running = 0;
+        for (int position = 0; position < 2 * DIAL_SIZE; ++position)
+        {
+            running += crossingDelta_[position];
+            covered[position] = running;
+        }
+        for (int start = 0; start < DIAL_SIZE; ++start)
+        {
+            segment_.crossingHits[start] = wholeTurns_ + covered[start] + covered[start + DIAL_SIZE];
+        }
+        segment_.displacement = position_;
+        return segment_;
+    }
+
+private:
+    LocateZeroHitsKernel locateZeroHits_;
+    DialSegment segment_;
+    std::array<int64_t, 2 * DIAL_SIZE> crossingDelta_{};
+    int64_t wholeTurns_ = 0;
+    int position_ = 0;
+};
+
+// Summarizes the rotations in `chunk`, parsed a block at a time
+DialSegment summarizeRotations(std::string_view chunk)
+{
+    SegmentBuilder builder;
+    std::array<int, ROTATION_BLOCK> block;
+    size_t count = 0;
+    for (std::string_view line : aoc::LineRange(chunk))
+    {
+        if (line.empty())
+            continue;
+
+        block[count++] = parseRotationValue(line);
+        if (count == ROTATION_BLOCK)
+        {
+            builder.add(block);
+            count = 0;
+        }
+    }
+    builder.add(std::span<const int>(block.data(), count));
+    return builder.finish();
+}
+
+// Rotations per task when summarizing parsed rotations
+constexpr size_t ROTATIONS_PER_TASK = 1U << 16;
+
+// Both counts for every start position, with the rotations cut into runs that
+// are summarized in parallel and folded in order
+DialSegment summarizeRotations(std::span<const int> rotations)
+{
+    size_t runs = (rotations.size() + ROTATIONS_PER_TASK - 1U) / ROTATIONS_PER_TASK;
+    return aoc::parallelReduce(
+        0U, runs, DialSegment{},
+        [&](size_t run)
+        {
+            size_t first = run * ROTATIONS_PER_TASK;
+            SegmentBuilder builder;
+            builder.add(rotations.subspan(first, std::min(ROTATIONS_PER_TASK, rotations.size() - first)));
+            return builder.finish();
+        },
+        [](DialSegment total, const DialSegment &next)
+        {
+            total.append(next);
+            return total;
+        },
+        1U);
 }
-int processInput(const std::string &filename, EvaluationStrategy method)
+
+DialSegment summarizeInput(aoc::ChunkSource &source)
 {
-    std::ifstream file(filename);
+    DialSegment total;
+    aoc::runPipeline(source, [](std::string_view chunk)
+                     { return summarizeRotations(chunk); }, [&](DialSegment &&segment)
+                     { total.append(segment); });
+    return total;
+}
 
-    if (!file.is_open())
+// Both counts for the input file in one read
+std::array<int64_t, 2> processInput(const std::string &filename)
+{
+    aoc::InputFile file(filename);
+
+    if (!file.isOpen())
     {
         std::cerr << "Error: Could not open file " << filename << std::endl;
-        return 0;
+        return {};
     }
 
-    int dialPosition = INITIAL_DIAL_POSITION;
-    int totalZeroHits = 0;
+    aoc::ChunkSource source(file.contents());
+    DialSegment total = summarizeInput(source);
+    return {total.zeroHits(INITIAL_DIAL_POSITION, EvaluationStrategy::ONLY_LANDING),
+            total.zeroHits(INITIAL_DIAL_POSITION, EvaluationStrategy::CROSSING_AND_LANDING)};
+}
 
-    std::string line;
-    while (std::getline(file, line))
+// Both counts for rotations piped to stdin, printing running totals as the
+// segments are folded
+int streamInput(const aoc::StreamOptions &options)
+{
+    DialSegment total;
+    auto printTotals = [&](const std::string &label)
+    {
+        std::cout << label << ":";
+        if (aoc::streamsPart(options, 1))
+            std::cout << " part 1 " << total.zeroHits(INITIAL_DIAL_POSITION, EvaluationStrategy::ONLY_LANDING);
+        if (aoc::streamsPart(options, 2))
+            std::cout << " part 2 " << total.zeroHits(INITIAL_DIAL_POSITION, EvaluationStrategy::CROSSING_AND_LANDING);
+        std::cout << std::endl;
+    };
+
+    aoc::ChunkSource source(STDIN_FILENO, options.chunkBytes);
+    aoc::runStreaming(
+        source, options, [](std::string_view chunk)
+        { return summarizeRotations(chunk); }, [&](DialSegment &&segment)
+        { total.append(segment); },
+        [&](size_t bytes)
+        { printTotals("After " + std::to_string(bytes) + " bytes"); });
+    printTotals("Total");
+    return 0;
+}
+
+std::pmr::vector<int> parseRotations(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+{
+    std::pmr::vector<int> rotations(memory);
+    for (std::string_view line : aoc::LineRange(input))
     {
         if (line.empty())
             continue;
 
-        int rotationValue = parseRotationValue(line);
-        auto [newPosition, zeroHits] = processRotation(dialPosition, rotationValue, method);
-        dialPosition = newPosition;
-        totalZeroHits += zeroHits;
+        rotations.push_back(parseRotationValue(line));
+    }
+    return rotations;
+}
+
+// Both counts on a dial of `dialSize` positions, starting from
+// INITIAL_DIAL_POSITION wrapped onto it
+std::array<int64_t, 2> processInputOnDial(const std::string &filename, uint32_t dialSize)
+{
+    aoc::InputFile file(filename);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return {};
     }
 
-    file.close();
-    return totalZeroHits;
+    auto rotations = parseRotations(file.contents());
+    return evaluateRotations<EvaluationStrategy::ONLY_LANDING, EvaluationStrategy::CROSSING_AND_LANDING>(
+        rotations, RuntimeDial(dialSize), INITIAL_DIAL_POSITION % dialSize);
 }
 
-int main()
+// One dial of a batch simulation
+struct DialSetup
 {
+    uint32_t size;
+    uint32_t startPosition; // below size
+};
+
+struct DialCounts
+{
+    int64_t landing;  // part 1 rule
+    int64_t crossing; // part 2 rule
+};
+
+// Advances `dialCount` dials through the rotations, one dial per vector lane.
+// Dial state is structure-of-arrays in doubles: positions, sizes and counts
+// are integers well below 2^53, so all of it is exact. The whole turns of a
+// rotation are its distance times the dial's reciprocal, rounded and then
+// corrected by at most one, which needs no per-lane integer division.
+template <size_t VECTOR_BYTES>
+AOC_ALWAYS_INLINE void simulateDialsBody(const int *rotations, size_t count, size_t dialCount, const double *sizes,
+                                         const double *reciprocals, double *positions, double *landing, double *crossing)
+{
+    using Vector = aoc::cpu::Vector<double, VECTOR_BYTES>;
+    constexpr size_t LANES = VECTOR_BYTES / sizeof(double);
+    // Adding and subtracting 2^52 rounds a smaller non-negative double to an integer
+    constexpr double ROUNDING = 4503599627370496.0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        int rotationValue = rotations[i];
+        double distance = std::abs(static_cast<double>(rotationValue));
+        Vector turnsRight = Vector{} + static_cast<double>(rotationValue);
+
+        // Lane groups are independent, so their updates overlap in the pipeline
+        for (size_t dial = 0; dial < dialCount; dial += LANES)
+        {
+            Vector size, reciprocal, position, landed, crossed;
+            std::memcpy(&size, sizes + dial, VECTOR_BYTES);
+            std::memcpy(&reciprocal, reciprocals + dial, VECTOR_BYTES);
+            std::memcpy(&position, positions + dial, VECTOR_BYTES);
+            std::memcpy(&landed, landing + dial, VECTOR_BYTES);
+            std::memcpy(&crossed, crossing + dial, VECTOR_BYTES);
+
+            Vector wholeTurns = (distance * reciprocal + ROUNDING) - ROUNDING;
+            Vector partial = distance - wholeTurns * size;
+            wholeTurns = partial < 0.0 ? wholeTurns - 1.0 : (partial >= size ? wholeTurns + 1.0 : wholeTurns);
+            partial = partial < 0.0 ? partial + size : (partial >= size ? partial - size : partial);
+
+            // Same rules as applyRotation; both directions are computed and
+            // one is kept, since the direction changes unpredictably
+            Vector right = position + partial;
+            Vector left = position >= partial ? position - partial : position + size - partial;
+            Vector passedRight = right >= size ? Vector{} + 1.0 : Vector{};
+            // Left passes zero when 0 < position <= partial; a dial at zero
+            // always has position <= partial, so that case is taken back out
+            Vector passedLeft = (position <= partial ? Vector{} + 1.0 : Vector{}) - (position == 0.0 ? Vector{} + 1.0 : Vector{});
+            right = right >= size ? right - size : right;
+            Vector next = turnsRight >= 0.0 ? right : left;
+            Vector passed = turnsRight >= 0.0 ? passedRight : passedLeft;
+            landed += next == 0.0 ? Vector{} + 1.0 : Vector{};
+            crossed += wholeTurns + passed;
+
+            std::memcpy(positions + dial, &next, VECTOR_BYTES);
+            std::memcpy(landing + dial, &landed, VECTOR_BYTES);
+            std::memcpy(crossing + dial, &crossed, VECTOR_BYTES);
+        }
+    }
+}
+
+using SimulateDialsKernel = void (*)(const int *, size_t, size_t, const double *, const double *, double *, double *, double *);
+
+void simulateDialsBaseline(const int *rotations, size_t count, size_t dialCount, const double *sizes,
+                           const double *reciprocals, double *positions, double *landing, double *crossing)
+{
+    simulateDialsBody<aoc::cpu::BASELINE_VECTOR_BYTES>(rotations, count, dialCount, sizes, reciprocals, positions, landing, crossing);
+}
+
+AOC_TARGET_SSE42 void simulateDialsSse42(const int *rotations, size_t count, size_t dialCount, const double *sizes,
+                                         const double *reciprocals, double *positions, double *landing, double *crossing)
+{
+    simulateDialsBody<aoc::cpu::SSE42_VECTOR_BYTES>(rotations, count, dialCount, sizes, reciprocals, positions, landing, crossing);
+}
+
+AOC_TARGET_AVX2 void simulateDialsAvx2(const int *rotations, size_t count, size_t dialCount, const double *sizes,
+                                       const double *reciprocals, double *positions, double *landing, double *crossing)
+{
+    simulateDialsBody<aoc::cpu::AVX2_VECTOR_BYTES>(rotations, count, dialCount, sizes, reciprocals, positions, landing, crossing);
+}
+
+AOC_TARGET_AVX512 void simulateDialsAvx512(const int *rotations, size_t count, size_t dialCount, const double *sizes,
+                                           const double *reciprocals, double *positions, double *landing, double *crossing)
+{
+    simulateDialsBody<aoc::cpu::AVX512_VECTOR_BYTES>(rotations, count, dialCount, sizes, reciprocals, positions, landing, crossing);
+}
+
+// Many dials of different sizes and start positions driven by one rotation
+// stream, for what-if runs. The stream is fed once, in pieces of any size;
+// each block of it is run through every dial while it is in cache.
+class DialBatch
+{
+public:
+    explicit DialBatch(std::span<const DialSetup> dials)
+        : dialCount_(dials.size()),
+          simulateDials_(aoc::cpu::select<SimulateDialsKernel>(simulateDialsBaseline, simulateDialsSse42,
+                                                               simulateDialsAvx2, simulateDialsAvx512))
+    {
+        // Padded to whole vectors of the widest level with one-position dials
+        size_t lanes = aoc::cpu::AVX512_VECTOR_BYTES / sizeof(double);
+        size_t padded = (dials.size() + lanes - 1U) / lanes * lanes;
+        sizes_.assign(padded, 1.0);
+        reciprocals_.assign(padded, 1.0);
+        positions_.assign(padded, 0.0);
+        landing_.assign(padded, 0.0);
+        crossing_.assign(padded, 0.0);
+        for (size_t d = 0; d < dials.size(); ++d)
+        {
+            sizes_[d] = dials[d].size;
+            reciprocals_[d] = 1.0 / dials[d].size;
+            positions_[d] = dials[d].startPosition;
+        }
+    }
+
+    void add(std::span<const int> rotations)
+    {
+        for (size_t offset = 0; offset < rotations.size(); offset += ROTATION_BLOCK)
+        {
+            size_t count = std::min(ROTATION_BLOCK, rotations.size() - offset);
+            simulateDials_(rotations.data() + offset, count, sizes_.size(), sizes_.data(), reciprocals_.data(),
+                           positions_.data(), landing_.data(), crossing_.data());
+        }
+    }
+
+    std::vector<DialCounts> counts() const
+    {
+        std::vector<DialCounts> result(dialCount_);
+        for (size_t d = 0; d < dialCount_; ++d)
+        {
+            result[d] = {static_cast<int64_t>(landing_[d]), static_cast<int64_t>(crossing_[d])};
+        }
+        return result;
+    }
+
+private:
+    size_t dialCount_;
+    SimulateDialsKernel simulateDials_;
+    std::vector<double> sizes_;
+    std::vector<double> reciprocals_;
+    std::vector<double> positions_;
+    std::vector<double> landing_;
+    std::vector<double> crossing_;
+};
+
+// Counts of every dial in `dials` for the rotations in the input file
+std::vector<DialCounts> processInputOnDials(const std::string &filename, std::span<const DialSetup> dials)
+{
+    aoc::InputFile file(filename);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return {};
+    }
+
+    DialBatch batch(dials);
+    batch.add(parseRotations(file.contents()));
+    return batch.counts();
+}
+
+// Dials written as SIZE:START[,SIZE:START...]; empty if malformed
+std::vector<DialSetup> parseDialSetups(std::string_view text)
+{
+    std::vector<DialSetup> dials;
+    const char *cursor = text.data();
+    const char *end = text.data() + text.size();
+    while (cursor < end)
+    {
+        DialSetup dial{0U, 0U};
+        const char *next = aoc::parseUnsigned(cursor, end, dial.size);
+        if (next == cursor || next == end || *next != ':')
+            return {};
+        cursor = next + 1;
+        next = aoc::parseUnsigned(cursor, end, dial.startPosition);
+        if (next == cursor || (next != end && *next != ',') || dial.size == 0U || dial.startPosition >= dial.size)
+            return {};
+        dials.push_back(dial);
+        cursor = next == end ? end : next + 1;
+    }
+    return dials;
+}
+
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int /* part */)
+{
+    return aoc::makeParsed(input, parseRotations);
+}
+
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part)
+{
+    const auto &rotations = aoc::parsedData<std::pmr::vector<int>>(parsed);
+    if (rotations.size() > ROTATIONS_PER_TASK)
+    {
+        auto method = (part == 1) ? EvaluationStrategy::ONLY_LANDING : EvaluationStrategy::CROSSING_AND_LANDING;
+        return summarizeRotations(rotations).zeroHits(INITIAL_DIAL_POSITION, method);
+    }
+
+    // Too few rotations to share out: walk them directly
+    constexpr FixedDial<DIAL_SIZE> dial;
+    if (part == 1)
+        return evaluateRotations<EvaluationStrategy::ONLY_LANDING>(rotations, dial, INITIAL_DIAL_POSITION)[0];
+    return evaluateRotations<EvaluationStrategy::CROSSING_AND_LANDING>(rotations, dial, INITIAL_DIAL_POSITION)[0];
+}
+
+} // namespace day01
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv)
+{
+    using namespace day01;
+
+    auto streamOptions = aoc::parseStreamOptions(argc, argv);
+    if (streamOptions.enabled)
+        return streamOptions.valid ? streamInput(streamOptions) : 1;
+
+    // --dial N simulates a dial of N positions instead of DIAL_SIZE; --dials
+    // SIZE:START,... runs a batch of dials over the input instead
+    uint32_t dialSize = DIAL_SIZE;
+    std::vector<DialSetup> dials;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Error: " << (arg.starts_with("--") ? "option needs a value: " : "unknown argument: ") << arg << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--dial SIZE | --dials SIZE:START[,SIZE:START...]]" << std::endl;
+            return 1;
+        }
+
+        std::string_view value = argv[++i];
+        bool valid = false;
+        if (arg == "--dial")
+        {
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), dialSize);
+            valid = error == std::errc() && end == value.data() + value.size() && dialSize > 0U;
+        }
+        else if (arg == "--dials")
+        {
+            dials = parseDialSetups(value);
+            valid = !dials.empty();
+        }
+        if (!valid)
+        {
+            std::cerr << "Error: invalid argument " << arg << " " << value << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--dial SIZE | --dials SIZE:START[,SIZE:START...]]" << std::endl;
+            return 1;
+        }
+    }
+
     std::string inputFile = "input/input.txt";
-    int part1Hits = processInput(inputFile, EvaluationStrategy::ONLY_LANDING);
-    std::cout << "Part 1: Number of times the dial was at position 0: " << part1Hits << std::endl;
+    if (!dials.empty())
+    {
+        auto counts = processInputOnDials(inputFile, dials);
+        for (size_t d = 0; d < counts.size(); ++d)
+        {
+            std::cout << "Dial " << dials[d].size << " from " << dials[d].startPosition << ": part 1 " << counts[d].landing
+                      << ", part 2 " << counts[d].crossing << std::endl;
+        }
+        return 0;
+    }
 
-    int part2Hits = processInput(inputFile, EvaluationStrategy::CROSSING_AND_LANDING);
+    auto [part1Hits, part2Hits] = dialSize == DIAL_SIZE ? processInput(inputFile) : processInputOnDial(inputFile, dialSize);
+    std::cout << "Part 1: Number of times the dial was at position 0: " << part1Hits << std::endl;
     std::cout << "Part 2: Number of times the dial was at position 0: " << part2Hits << std::endl;
     return 0;
 }
+#endif
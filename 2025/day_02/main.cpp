@@ -1,107 +1,373 @@
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "common/input_reader.hpp"
+#include "common/parse.hpp"
+#include "common/solver.hpp"
+#include "common/thread_pool.hpp"
+#include "common/trace.hpp"
+
+namespace day02
+{
+
 using IdType = long long;
-std::vector<std::pair<IdType, IdType>> readInputFile(std::string const &filePath)
+using IdRanges = std::pmr::vector<std::pair<IdType, IdType>>;
+
+IdRanges parseInput(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+{
+    IdRanges data(memory);
+    auto lines = aoc::LineRange(input);
+    if (lines.begin() == lines.end())
+        return data;
+
+    std::string_view line = *lines.begin();
+    const char *cursor = line.data();
+    const char *end = line.data() + line.size();
+    while (cursor < end)
+    {
+        IdType first = 0;
+        IdType second = 0;
+        cursor = aoc::parseUnsigned(cursor, end, first);
+        if (cursor >= end || *cursor != '-')
+            break;
+
+        cursor = aoc::parseUnsigned(cursor + 1, end, second);
+        data.push_back({first, second});
+        AOC_TRACE(aoc::TraceLevel::DEBUG, "Read " << first << "-" << second);
+        cursor = aoc::skipToNumber(cursor, end);
+    }
+
+    return data;
+}
+
+IdRanges readInputFile(std::string const &filePath)
 {
-    std::vector<std::pair<IdType, IdType>> data;
-    std::ifstream file(filePath);
+    aoc::InputFile file(filePath);
 
-    if (!file.is_open())
+    if (!file.isOpen())
     {
         std::cerr << "Error: Could not open file " << filePath << std::endl;
-        return data;
+        return {};
     }
 
-    std::string line;
-    std::getline(file, line);
+    return parseInput(file.contents());
+}
 
-    size_t pos = 0;
-    while (pos < line.length())
+// Decimal digits of an ID, most significant first, kept in step with the ID
+// as it is incremented, so a scan never converts IDs to text. The buffer is
+// zero past the last digit and long enough for equalDigits() to read whole
+// words beyond it.
+class IdDigits
+{
+public:
+    explicit IdDigits(IdType id) : value_(id)
     {
-        size_t dashPos = line.find('-', pos);
-        if (dashPos == std::string::npos)
-            break;
+        char text[CAPACITY];
+        auto [end, error] = std::to_chars(text, text + CAPACITY, id);
+        size_ = static_cast<int>(end - text);
+        for (int i = 0; i < size_; ++i)
+            digits_[i] = static_cast<uint8_t>(text[i] - '0');
+    }
 
-        size_t commaPos = line.find(',', dashPos);
-        if (commaPos == std::string::npos)
-            commaPos = line.length();
+    IdType value() const { return value_; }
+    int size() const { return size_; }
+    const uint8_t *data() const { return digits_.data(); }
 
-        IdType first = std::stoll(line.substr(pos, dashPos - pos));
-        IdType second = std::stoll(line.substr(dashPos + 1, commaPos - dashPos - 1));
-        data.push_back({first, second});
-        std::cout << "Read " << first << "-" << second << std::endl;
-        pos = commaPos + 1;
+    void increment()
+    {
+        value_++;
+        int i = size_ - 1;
+        for (; i >= 0 && digits_[i] == 9U; --i)
+            digits_[i] = 0U;
+        if (i >= 0)
+        {
+            digits_[i]++;
+            return;
+        }
+        // 99...9 became 100...0
+        digits_[0] = 1U;
+        digits_[size_] = 0U;
+        size_++;
     }
 
-    file.close();
-    return data;
+private:
+    static constexpr int CAPACITY = 32;
+
+    IdType value_;
+    int size_;
+    std::array<uint8_t, CAPACITY> digits_{};
+};
+
+// Whether `count` digits at a and b match, compared eight at a time; both may
+// be read up to seven bytes past `count`
+bool equalDigits(const uint8_t *a, const uint8_t *b, int count)
+{
+    for (; count > 0; count -= 8, a += 8, b += 8)
+    {
+        uint64_t wordA, wordB;
+        std::memcpy(&wordA, a, sizeof(wordA));
+        std::memcpy(&wordB, b, sizeof(wordB));
+        uint64_t difference = wordA ^ wordB;
+        if (count < 8)
+            difference &= (uint64_t{1} << (8 * count)) - 1U;
+        if (difference != 0U)
+            return false;
+    }
+    return true;
 }
 
-bool isInvalidPart1(IdType id)
+// Predicates for the range scan (sumInvalidIds)
+bool isInvalidPart1(const IdDigits &id)
 {
     // find the invalid IDs by looking for any ID which is made only of some
     // sequence of digits repeated twice. So, 55 (5 twice), 6464 (64 twice), and
     // 123123 (123 twice) would all be invalid IDs.
 
-    std::string idStr = std::to_string(id);
-    size_t len = idStr.length();
-
+    int len = id.size();
     if (len % 2 != 0)
         return false; // must be even length
 
-    std::string firstHalf = idStr.substr(0, len / 2);
-    std::string secondHalf = idStr.substr(len / 2, len / 2);
-    return firstHalf == secondHalf;
+    return equalDigits(id.data(), id.data() + len / 2, len / 2);
 }
 
-bool isInvalidPart2(IdType id)
+bool isInvalidPart2(const IdDigits &id)
 {
     // an ID is invalid if it is made only of some sequence of digits repeated
     // at least twice. So, 12341234 (1234 two times), 123123123 (123 three
     // times), 1212121212 (12 five times), and 1111111 (1 seven times) are all
     // invalid IDs.
 
-    std::string idStr = std::to_string(id);
-    size_t len = idStr.length();
-
-    for (size_t patternLength = 1; patternLength <= len / 2; patternLength++)
+    int len = id.size();
+    for (int patternLength = 1; patternLength <= len / 2; patternLength++)
     {
         if (len % patternLength != 0)
             continue; // must divide evenly
 
-        std::string pattern = idStr.substr(0, patternLength);
-        size_t numRepeats = len / patternLength;
-        std::string constructed;
-        for (size_t i = 0; i < numRepeats; i++)
-        {
-            constructed += pattern;
-        }
-        if (constructed == idStr)
+        // The digits repeat the first patternLength of them exactly when
+        // they equal themselves shifted by patternLength
+        if (equalDigits(id.data(), id.data() + patternLength, len - patternLength))
             return true;
     }
     return false;
 }
 
-int main()
+// Invalid IDs in closed form. An ID of `digits` digits made of a
+// `period`-digit pattern repeated is pattern * R, with the repunit-style
+// multiplier R = (10^digits - 1) / (10^period - 1), e.g. 1001001 for a
+// 3-digit pattern repeated 3 times. The patterns in a range are consecutive
+// integers, so the sum of those IDs is R times an arithmetic series.
+//
+// Part 1 is period digits / 2. Part 2 is the union over every proper period;
+// IDs with periods a and b also have period gcd(a, b), so by
+// inclusion-exclusion the union is
+//
+//   sum over d | digits, d > 1, of -mu(d) * (IDs with period digits / d)
+//
+// which counts an ID like 111111 once. Each range costs
+// O(digit lengths * divisors), however wide it is.
+using WideSum = __int128;
+
+// Enough digits for any non-negative IdType
+constexpr int MAX_ID_DIGITS = 19;
+
+constexpr WideSum powerOfTen(int exponent)
+{
+    WideSum power = 1;
+    for (int i = 0; i < exponent; ++i)
+        power *= 10;
+    return power;
+}
+
+int digitCount(IdType id)
+{
+    int digits = 1;
+    while (id >= 10)
+    {
+        id /= 10;
+        digits++;
+    }
+    return digits;
+}
+
+// Moebius function for the small n that divide an ID length
+int moebius(int n)
+{
+    int result = 1;
+    for (int factor = 2; factor * factor <= n; ++factor)
+    {
+        if (n % factor != 0)
+            continue;
+        n /= factor;
+        if (n % factor == 0)
+            return 0; // square factor
+        result = -result;
+    }
+    return n > 1 ? -result : result;
+}
+
+// Sum of the IDs in [first, last], all of `digits` digits, that repeat a
+// `period`-digit pattern
+WideSum sumRepeatedPatterns(IdType first, IdType last, int digits, int period)
+{
+    WideSum multiplier = (powerOfTen(digits) - 1) / (powerOfTen(period) - 1);
+    // Patterns have exactly `period` digits and their IDs lie in the range
+    WideSum lowest = std::max(powerOfTen(period - 1), (first + multiplier - 1) / multiplier);
+    WideSum highest = std::min(powerOfTen(period) - 1, last / multiplier);
+    if (lowest > highest)
+        return 0;
+    return multiplier * ((lowest + highest) * (highest - lowest + 1) / 2);
+}
+
+// Sum of the invalid IDs in [first, last] under the rule of `part`
+WideSum sumInvalidInRange(IdType first, IdType last, int part)
 {
-    IdType invalidIdSum = 0;
-    std::vector<std::pair<IdType, IdType>> data = readInputFile("input/input.txt");
-    for (auto const &p : data)
+    WideSum sum = 0;
+    for (int digits = digitCount(first); digits <= digitCount(last); ++digits)
     {
-        for (IdType i = p.first; i <= p.second; ++i)
+        // The IDs of the range that have exactly `digits` digits
+        IdType lengthFirst = std::max<IdType>(first, static_cast<IdType>(powerOfTen(digits - 1)));
+        IdType lengthLast = digits == MAX_ID_DIGITS ? last : std::min<IdType>(last, static_cast<IdType>(powerOfTen(digits) - 1));
+
+        if (part == 1)
+        {
+            if (digits % 2 == 0)
+                sum += sumRepeatedPatterns(lengthFirst, lengthLast, digits, digits / 2);
+            continue;
+        }
+
+        for (int repeats = 2; repeats <= digits; ++repeats)
         {
-            if (isInvalidPart2(i))
+            if (digits % repeats == 0)
+                sum -= moebius(repeats) * sumRepeatedPatterns(lengthFirst, lengthLast, digits, digits / repeats);
+        }
+    }
+    return sum;
+}
+
+// Sorted, with overlapping and adjacent ranges joined. Both engines sum over
+// the merged ranges, so an ID listed in two ranges counts once.
+std::vector<std::pair<IdType, IdType>> mergeRanges(IdRanges const &data)
+{
+    std::vector<std::pair<IdType, IdType>> ranges(data.begin(), data.end());
+    std::sort(ranges.begin(), ranges.end());
+
+    size_t merged = 0;
+    for (auto const &range : ranges)
+    {
+        if (merged > 0 && range.first <= ranges[merged - 1].second + 1)
+            ranges[merged - 1].second = std::max(ranges[merged - 1].second, range.second);
+        else
+            ranges[merged++] = range;
+    }
+    ranges.resize(merged);
+    return ranges;
+}
+
+IdType sumInvalidIdsClosedForm(IdRanges const &data, int part)
+{
+    WideSum invalidIdSum = 0;
+    for (auto const &p : mergeRanges(data))
+        invalidIdSum += sumInvalidInRange(p.first, p.second, part);
+    return static_cast<IdType>(invalidIdSum);
+}
+
+// IDs per pool task. Ranges differ in length by orders of magnitude, so they
+// are cut into blocks of this size before being handed out.
+constexpr IdType IDS_PER_TASK = 4096;
+
+// Sum of the IDs in the ranges for which isInvalid(const IdDigits &) holds,
+// visiting every ID. For predicates without a closed form; blocks of the
+// merged ranges are spread over the pool and each walks its IDs as digits,
+// incremented in place, without allocating.
+template <typename Predicate>
+IdType sumInvalidIds(IdRanges const &data, Predicate isInvalid)
+{
+    auto ranges = mergeRanges(data);
+
+    // Index of the first block of every range, and the total
+    std::vector<size_t> firstBlock(ranges.size() + 1U, 0U);
+    for (size_t r = 0; r < ranges.size(); ++r)
+        firstBlock[r + 1] = firstBlock[r] + static_cast<size_t>((ranges[r].second - ranges[r].first) / IDS_PER_TASK) + 1U;
+
+    return aoc::parallelReduce(
+        0U, firstBlock.back(), IdType{0},
+        [&](size_t block)
+        {
+            size_t r = std::upper_bound(firstBlock.begin(), firstBlock.end(), block) - firstBlock.begin() - 1;
+            IdType first = ranges[r].first + static_cast<IdType>(block - firstBlock[r]) * IDS_PER_TASK;
+            IdType last = std::min(ranges[r].second, first + IDS_PER_TASK - 1);
+
+            IdType invalidIdSum = 0;
+            for (IdDigits id(first);; id.increment())
             {
-                std::cout << "Invalid ID: " << i << std::endl;
-                invalidIdSum += i;
+                if (isInvalid(id))
+                {
+                    AOC_TRACE(aoc::TraceLevel::VERBOSE, "Invalid ID: " << id.value());
+                    invalidIdSum += id.value();
+                }
+                if (id.value() == last)
+                    break;
             }
+            return invalidIdSum;
+        },
+        std::plus<IdType>(), 1U);
+}
+
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int /* part */)
+{
+    return aoc::makeParsed(input, parseInput);
+}
+
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part)
+{
+    const auto &data = aoc::parsedData<IdRanges>(parsed);
+    return sumInvalidIdsClosedForm(data, part);
+}
+
+} // namespace day02
+
+#ifndef AOC_RUNNER
+int main(int argc, char *argv[])
+{
+    using namespace day02;
+
+    // --scan visits every ID instead of using the closed form; --part 1|2
+    // picks the rule (part 2 by default)
+    bool scan = false;
+    int part = 2;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg == "--scan")
+        {
+            scan = true;
+        }
+        else if (arg == "--part" && i + 1 < argc && (std::string_view(argv[i + 1]) == "1" || std::string_view(argv[i + 1]) == "2"))
+        {
+            part = argv[++i][0] - '0';
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--scan] [--part 1|2]" << std::endl;
+            return 1;
         }
     }
 
+    IdRanges data = readInputFile("input/input.txt");
+    IdType invalidIdSum = scan ? sumInvalidIds(data, part == 1 ? isInvalidPart1 : isInvalidPart2) : sumInvalidIdsClosedForm(data, part);
+
     std::cout << "Sum of invalid IDs: " << invalidIdSum << std::endl;
     return 0;
 }
+#endif
@@ -1,29 +1,44 @@
-#include <fstream>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "common/input_reader.hpp"
+#include "common/pipeline.hpp"
+#include "common/solver.hpp"
+#include "common/stream.hpp"
+#include "common/thread_pool.hpp"
+#include "common/trace.hpp"
+
+namespace day03
+{
+
+constexpr size_t PART1_BATTERIES_COUNT = 2;
 constexpr size_t BATTERIES_COUNT = 12;
 
-uint64_t getBankJoltage(std::string const &bank)
+uint64_t getBankJoltage(std::string_view bank, size_t batteriesCount = BATTERIES_COUNT)
 {
     size_t bankSize = bank.size();
     std::vector<char> selectedBatteries;
-    selectedBatteries.reserve(BATTERIES_COUNT);
+    selectedBatteries.reserve(batteriesCount);
 
     for (size_t bankIndex = 0; bankIndex < bankSize; bankIndex++)
     {
         // We can pop only a certain number of selected batteries. If we remove
         // too much, we won't be able to form a full size pack
-        int removableBatteriesCount = selectedBatteries.size() + bankSize - bankIndex - BATTERIES_COUNT;
+        int removableBatteriesCount = selectedBatteries.size() + bankSize - bankIndex - batteriesCount;
         while ((!selectedBatteries.empty()) && (removableBatteriesCount > 0) && (bank[bankIndex] > selectedBatteries.back()))
         {
             selectedBatteries.pop_back();
             removableBatteriesCount--;
         }
 
-        if (selectedBatteries.size() != BATTERIES_COUNT)
+        if (selectedBatteries.size() != batteriesCount)
         {
             selectedBatteries.push_back(bank[bankIndex]);
         }
@@ -37,36 +52,125 @@ uint64_t getBankJoltage(std::string const &bank)
     return joltage;
 }
 
-uint64_t processInputFile(std::string const &filePath)
+std::pmr::vector<std::string_view> parseInput(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+{
+    std::pmr::vector<std::string_view> banks(memory);
+    for (std::string_view bank : aoc::LineRange(input))
+    {
+        if (bank.empty())
+            continue;
+
+        banks.push_back(bank);
+    }
+    return banks;
+}
+
+uint64_t sumBankJoltages(const std::pmr::vector<std::string_view> &banks, size_t batteriesCount)
+{
+    return aoc::parallelReduce(
+        0U, banks.size(), uint64_t{0},
+        [&](size_t index)
+        {
+            auto bankJoltage = getBankJoltage(banks[index], batteriesCount);
+            AOC_TRACE(aoc::TraceLevel::DEBUG, "Bank: " << banks[index] << " -> Joltage: " << bankJoltage);
+            return bankJoltage;
+        },
+        std::plus<uint64_t>());
+}
+
+// Joltage of every bank in a chunk of whole lines
+uint64_t sumChunkJoltages(std::string_view chunk, size_t batteriesCount)
+{
+    uint64_t joltageSum = 0U;
+    for (std::string_view bank : aoc::LineRange(chunk))
+    {
+        if (!bank.empty())
+            joltageSum += getBankJoltage(bank, batteriesCount);
+    }
+    return joltageSum;
+}
+
+uint64_t sumBankJoltages(aoc::ChunkSource &source, size_t batteriesCount)
+{
+    uint64_t joltageSum = 0U;
+    aoc::runPipeline(
+        source, [&](std::string_view chunk)
+        { return sumChunkJoltages(chunk, batteriesCount); },
+        [&](uint64_t chunkJoltage)
+        { joltageSum += chunkJoltage; });
+    return joltageSum;
+}
+
+uint64_t processInputFile(std::string const &filePath, size_t batteriesCount = BATTERIES_COUNT)
 {
-    std::ifstream file(filePath);
+    aoc::InputFile file(filePath);
 
-    if (!file.is_open())
+    if (!file.isOpen())
     {
         std::cerr << "Error: Could not open file " << filePath << std::endl;
         return 0;
     }
 
-    uint64_t joltageSum = 0U;
-    std::string bank;
-    while (std::getline(file, bank))
+    aoc::ChunkSource source(file.contents());
+    return sumBankJoltages(source, batteriesCount);
+}
+
+// Banks piped to stdin; both parts are summed in the same pass
+int streamInput(const aoc::StreamOptions &options)
+{
+    uint64_t part1Sum = 0U, part2Sum = 0U;
+    auto printTotals = [&](const std::string &label)
     {
-        if (bank.empty())
-            continue;
+        std::cout << label << ":";
+        if (aoc::streamsPart(options, 1))
+            std::cout << " part 1 " << part1Sum;
+        if (aoc::streamsPart(options, 2))
+            std::cout << " part 2 " << part2Sum;
+        std::cout << std::endl;
+    };
 
-        auto bankJoltage = getBankJoltage(bank);
-        std::cout << "Bank: " << bank << " -> Joltage: " << bankJoltage << std::endl;
-        joltageSum += bankJoltage;
-    }
+    aoc::ChunkSource source(STDIN_FILENO, options.chunkBytes);
+    aoc::runStreaming(
+        source, options, [&](std::string_view chunk)
+        {
+            uint64_t part1 = aoc::streamsPart(options, 1) ? sumChunkJoltages(chunk, PART1_BATTERIES_COUNT) : 0U;
+            uint64_t part2 = aoc::streamsPart(options, 2) ? sumChunkJoltages(chunk, BATTERIES_COUNT) : 0U;
+            return std::make_pair(part1, part2); },
+        [&](std::pair<uint64_t, uint64_t> chunkSums)
+        {
+            part1Sum += chunkSums.first;
+            part2Sum += chunkSums.second; },
+        [&](size_t bytes)
+        { printTotals("After " + std::to_string(bytes) + " bytes"); });
+    printTotals("Total");
+    return 0;
+}
 
-    file.close();
-    return joltageSum;
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int /* part */)
+{
+    return aoc::makeParsed(input, parseInput);
 }
 
-int main()
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part)
 {
+    const auto &banks = aoc::parsedData<std::pmr::vector<std::string_view>>(parsed);
+    return sumBankJoltages(banks, part == 1 ? PART1_BATTERIES_COUNT : BATTERIES_COUNT);
+}
+
+} // namespace day03
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv)
+{
+    using namespace day03;
+
+    auto streamOptions = aoc::parseStreamOptions(argc, argv);
+    if (streamOptions.enabled)
+        return streamOptions.valid ? streamInput(streamOptions) : 1;
+
     auto maxJoltage = processInputFile("input/input.txt");
 
     std::cout << "Max joltage: " << maxJoltage << std::endl;
     return 0;
 }
+#endif
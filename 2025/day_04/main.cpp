@@ -1,74 +1,146 @@
-#include <fstream>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
-using PaperGridType = std::vector<std::vector<bool>>;
-using AdjacentGridType = std::vector<std::vector<int>>;
+#include "common/cpu_dispatch.hpp"
+#include "common/grid.hpp"
+#include "common/huge_pages.hpp"
+#include "common/input_reader.hpp"
+#include "common/solver.hpp"
+#include "common/trace.hpp"
+
+namespace day04
+{
+
+// Both grids have a one-cell empty border, so neighbour loops need no checks
+using PaperGridType = aoc::Grid<bool>;
+using AdjacentGridType = aoc::Grid<int>;
 constexpr int PAPER_ACCESS_THRESHOLD = 4;
 constexpr bool IS_PART_2 = true;
 
-PaperGridType readInputFile(std::string const &filePath)
+PaperGridType parseInput(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
 {
-    std::ifstream file(filePath);
-
-    if (!file.is_open())
+    size_t numRows = 0U, numCols = 0U;
+    for (std::string_view line : aoc::LineRange(input))
     {
-        std::cerr << "Error: Could not open file " << filePath << std::endl;
-        return {};
+        if (line.empty())
+            continue;
+        numRows++;
+        numCols = std::max(numCols, line.size());
     }
 
-    PaperGridType grid;
-    std::string line;
-    while (std::getline(file, line))
+    PaperGridType grid(numRows, numCols, 1U, memory);
+    ptrdiff_t r = 0;
+    for (std::string_view line : aoc::LineRange(input))
     {
         if (line.empty())
             continue;
 
-        std::vector<bool> row;
-        row.reserve(line.size());
-        for (char c : line)
+        for (size_t c = 0; c < line.size(); ++c)
         {
-            row.push_back(c == '@');
+            if (line[c] == '@')
+                grid.set(r, c);
         }
-        grid.push_back(row);
+        r++;
     }
 
     return grid;
 }
 
+PaperGridType readInputFile(std::string const &filePath)
+{
+    aoc::InputFile file(filePath);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open file " << filePath << std::endl;
+        return {};
+    }
+
+    return parseInput(file.contents());
+}
+
+// Paper neighbours of cells [0, width) of `row`, given the rows above and
+// below. Rows hold one byte per cell (0 or 1) and are readable one cell past
+// either end, where they are zero.
+template <size_t VECTOR_BYTES>
+AOC_ALWAYS_INLINE void countNeighboursBody(const uint8_t *above, const uint8_t *row, const uint8_t *below, size_t width, int *out)
+{
+    // Counts fit in a byte; they are widened to int once per vector
+    constexpr size_t LANES = VECTOR_BYTES / sizeof(int);
+    using Bytes = aoc::cpu::Vector<uint8_t, LANES>;
+    using Ints = aoc::cpu::Vector<int, VECTOR_BYTES>;
+    auto load = [](const uint8_t *cells)
+    {
+        Bytes bytes;
+        std::memcpy(&bytes, cells, LANES);
+        return bytes;
+    };
+
+    size_t c = 0;
+    for (; c + LANES <= width; c += LANES)
+    {
+        Bytes sum = load(above + c - 1) + load(above + c) + load(above + c + 1) + load(row + c - 1) +
+                    load(row + c + 1) + load(below + c - 1) + load(below + c) + load(below + c + 1);
+        Ints counts = __builtin_convertvector(sum, Ints);
+        std::memcpy(out + c, &counts, VECTOR_BYTES);
+    }
+    for (; c < width; ++c)
+    {
+        out[c] = above[c - 1] + above[c] + above[c + 1] + row[c - 1] + row[c + 1] + below[c - 1] + below[c] + below[c + 1];
+    }
+}
+
+using CountNeighboursKernel = void (*)(const uint8_t *, const uint8_t *, const uint8_t *, size_t, int *);
+
+void countNeighboursBaseline(const uint8_t *above, const uint8_t *row, const uint8_t *below, size_t width, int *out)
+{
+    countNeighboursBody<aoc::cpu::BASELINE_VECTOR_BYTES>(above, row, below, width, out);
+}
+
+AOC_TARGET_SSE42 void countNeighboursSse42(const uint8_t *above, const uint8_t *row, const uint8_t *below, size_t width, int *out)
+{
+    countNeighboursBody<aoc::cpu::SSE42_VECTOR_BYTES>(above, row, below, width, out);
+}
+
+AOC_TARGET_AVX2 void countNeighboursAvx2(const uint8_t *above, const uint8_t *row, const uint8_t *below, size_t width, int *out)
+{
+    countNeighboursBody<aoc::cpu::AVX2_VECTOR_BYTES>(above, row, below, width, out);
+}
+
+AOC_TARGET_AVX512 void countNeighboursAvx512(const uint8_t *above, const uint8_t *row, const uint8_t *below, size_t width, int *out)
+{
+    countNeighboursBody<aoc::cpu::AVX512_VECTOR_BYTES>(above, row, below, width, out);
+}
+
 AdjacentGridType computeAdjacentGrid(const PaperGridType &paperGrid)
 {
-    int numRows = paperGrid.size();
-    int numCols = paperGrid.empty() ? 0 : paperGrid[0].size();
-    AdjacentGridType adjacentGrid(numRows, std::vector<int>(numCols, 0));
+    int numRows = paperGrid.rows();
+    int numCols = paperGrid.cols();
+    // Lives next to the paper grid, in the same arena when it has one
+    AdjacentGridType adjacentGrid(numRows, numCols, 1U, paperGrid.resource());
 
+    // One byte per cell, for the kernel
+    aoc::Grid<uint8_t> cells(numRows, numCols, 1U, aoc::largeTableResource());
     for (int r = 0; r < numRows; ++r)
     {
-        for (int c = 0; c < numCols; ++c)
-        {
-            if (paperGrid[r][c])
-            {
-                // Increment adjacent cells
-                for (int dr = -1; dr <= 1; ++dr)
-                {
-                    for (int dc = -1; dc <= 1; ++dc)
-                    {
-                        if (dr == 0 && dc == 0)
-                            continue; // skip the cell itself
-
-                        int nr = r + dr;
-                        int nc = c + dc;
+        paperGrid.forEachSet(r, [&](ptrdiff_t c)
+                             { cells(r, c) = 1U; });
+    }
 
-                        if (nr < numRows && nc < numCols && nr >= 0 && nc >= 0)
-                        {
-                            adjacentGrid[nr][nc]++;
-                        }
-                    }
-                }
-            }
-        }
+    CountNeighboursKernel countNeighbours = aoc::cpu::select<CountNeighboursKernel>(
+        countNeighboursBaseline, countNeighboursSse42, countNeighboursAvx2, countNeighboursAvx512);
+    for (int r = 0; r < numRows; ++r)
+    {
+        countNeighbours(cells.rowData(r - 1), cells.rowData(r), cells.rowData(r + 1), numCols, adjacentGrid.rowData(r));
     }
 
     return adjacentGrid;
@@ -77,23 +149,27 @@ AdjacentGridType computeAdjacentGrid(const PaperGridType &paperGrid)
 int countRemovablePapers(const PaperGridType &paperGrid, const AdjacentGridType &adjacentGrid)
 {
     int count = 0;
-    int numRows = paperGrid.size();
-    int numCols = paperGrid.empty() ? 0 : paperGrid[0].size();
+    int numRows = paperGrid.rows();
+    int numCols = paperGrid.cols();
+    bool traceGrid = AOC_TRACE_ON(aoc::TraceLevel::VERBOSE);
+    std::string rowTrace;
     for (int r = 0; r < numRows; ++r)
     {
         for (int c = 0; c < numCols; ++c)
         {
-            if (paperGrid[r][c] && adjacentGrid[r][c] < PAPER_ACCESS_THRESHOLD)
+            if (paperGrid(r, c) && adjacentGrid(r, c) < PAPER_ACCESS_THRESHOLD)
             {
-                std::cout << 'x';
+                if (traceGrid)
+                    rowTrace.push_back('x');
                 count++;
             }
-            else
+            else if (traceGrid)
             {
-                std::cout << (paperGrid[r][c] ? '@' : '.');
+                rowTrace.push_back(paperGrid(r, c) ? '@' : '.');
             }
         }
-        std::cout << std::endl;
+        AOC_TRACE(aoc::TraceLevel::VERBOSE, rowTrace);
+        rowTrace.clear();
     }
     return count;
 }
@@ -101,32 +177,26 @@ int countRemovablePapers(const PaperGridType &paperGrid, const AdjacentGridType
 int removePapersRecursively(PaperGridType &paperGrid, AdjacentGridType &adjacentGrid)
 {
     int removedPapers = 0;
-    int numRows = paperGrid.size();
-    int numCols = paperGrid.empty() ? 0 : paperGrid[0].size();
+    int numRows = paperGrid.rows();
+    int numCols = paperGrid.cols();
     for (int r = 0; r < numRows; ++r)
     {
         for (int c = 0; c < numCols; ++c)
         {
-            if (paperGrid[r][c] && adjacentGrid[r][c] < PAPER_ACCESS_THRESHOLD)
+            if (paperGrid(r, c) && adjacentGrid(r, c) < PAPER_ACCESS_THRESHOLD)
             {
-                paperGrid[r][c] = false;
+                paperGrid.set(r, c, false);
                 removedPapers++;
 
-                // Update adjacent grid
+                // Update adjacent grid; the border absorbs updates past the edges
                 for (int dr = -1; dr <= 1; ++dr)
                 {
                     for (int dc = -1; dc <= 1; ++dc)
                     {
-                        if (dr == 0 && dc == 0)
-                            continue; // skip the cell itself
-                        int nr = r + dr;
-                        int nc = c + dc;
-                        if (nr < numRows && nc < numCols && nr >= 0 && nc >= 0)
-                        {
-                            adjacentGrid[nr][nc]--;
-                        }
+                        adjacentGrid(r + dr, c + dc)--;
                     }
                 }
+                adjacentGrid(r, c)++; // the cell itself is not its own neighbour
             }
         }
     }
@@ -138,8 +208,58 @@ int removePapersRecursively(PaperGridType &paperGrid, AdjacentGridType &adjacent
     }
     return removedPapers;
 }
+
+// Binary cache columns: the grid shape (rows, columns, words per row) and the
+// grid's own bit-packed rows, halo bits included, copied word for word
+void storeParsed(aoc::ParsedInput &parsed, aoc::CacheWriter &cache)
+{
+    const auto &grid = aoc::parsedData<PaperGridType>(parsed);
+    std::vector<uint64_t> words;
+    words.reserve(grid.rows() * grid.wordsPerRow());
+    for (size_t r = 0; r < grid.rows(); ++r)
+    {
+        auto row = grid.rowWords(r);
+        words.insert(words.end(), row.begin(), row.end());
+    }
+    cache.addColumn<uint64_t>(std::vector<size_t>{grid.rows(), grid.cols(), grid.wordsPerRow()});
+    cache.addColumn<uint64_t>(words);
+}
+
+std::unique_ptr<aoc::ParsedInput> loadParsed(const aoc::CacheFile &cache)
+{
+    auto shape = cache.column<uint64_t>(0);
+    auto words = cache.column<uint64_t>(1);
+    if (cache.columnCount() != 2U || shape.size() != 3U || words.size() != shape[0] * shape[2] ||
+        PaperGridType(0U, shape[1]).wordsPerRow() != shape[2])
+        return nullptr;
+
+    return aoc::makeLoaded(cache, [&](const aoc::CacheFile &, std::pmr::memory_resource *memory)
+                           {
+        PaperGridType grid(shape[0], shape[1], 1U, memory);
+        for (size_t r = 0; r < shape[0]; ++r)
+            std::memcpy(grid.rowWords(r).data(), words.data() + r * shape[2], shape[2] * sizeof(uint64_t));
+        return grid; });
+}
+
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int /* part */)
+{
+    return aoc::makeParsed(input, parseInput);
+}
+
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part)
+{
+    auto &grid = aoc::parsedData<PaperGridType>(parsed);
+    auto adjacentGrid = computeAdjacentGrid(grid);
+    return part == 1 ? countRemovablePapers(grid, adjacentGrid) : removePapersRecursively(grid, adjacentGrid);
+}
+
+} // namespace day04
+
+#ifndef AOC_RUNNER
 int main()
 {
+    using namespace day04;
+
     auto grid = readInputFile("input/sample.txt");
     auto adjacentGrid = computeAdjacentGrid(grid);
 
@@ -155,3 +275,4 @@ int main()
     }
     return 0;
 }
+#endif
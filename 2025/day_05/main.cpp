@@ -1,34 +1,38 @@
+#include <algorithm>
 #include <deque>
-#include <fstream>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "common/input_reader.hpp"
+#include "common/parse.hpp"
+#include "common/pipeline.hpp"
+#include "common/solver.hpp"
+#include "common/stream.hpp"
+#include "common/trace.hpp"
+
+namespace day05
+{
+
 using Id = unsigned long long;
 using IdRange = std::pair<Id, Id>;
 
 class InputData
 {
 public:
-    std::deque<IdRange> freshIds;
-    std::vector<Id> availableIds;
+    std::pmr::deque<IdRange> freshIds;
+    std::pmr::vector<Id> availableIds;
 };
 
-InputData readInputFile(std::string const &filePath)
+InputData parseInput(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
 {
     bool blankLineEncountered = false;
-    std::ifstream file(filePath);
-
-    if (!file.is_open())
-    {
-        std::cerr << "Error: Could not open file " << filePath << std::endl;
-        return {};
-    }
-
-    InputData inputData;
-    std::string line;
-    while (std::getline(file, line))
+    InputData inputData{std::pmr::deque<IdRange>(memory), std::pmr::vector<Id>(memory)};
+    for (std::string_view line : aoc::LineRange(input))
     {
         if (line.empty())
         {
@@ -38,17 +42,20 @@ InputData readInputFile(std::string const &filePath)
 
         if (!blankLineEncountered)
         {
-            size_t dashPos = line.find('-');
-            if (dashPos == std::string::npos)
+            const char *end = line.data() + line.size();
+            Id first = 0;
+            Id second = 0;
+            const char *cursor = aoc::parseUnsigned(line.data(), end, first);
+            if (cursor >= end || *cursor != '-')
                 continue;
 
-            Id first = std::stoull(line.substr(0, dashPos));
-            Id second = std::stoull(line.substr(dashPos + 1));
+            aoc::parseUnsigned(cursor + 1, end, second);
             inputData.freshIds.push_back({first, second});
         }
         else
         {
-            Id id = std::stoull(line);
+            Id id = 0;
+            aoc::parseUnsigned(line.data(), line.data() + line.size(), id);
             inputData.availableIds.push_back(id);
         }
     }
@@ -56,30 +63,105 @@ InputData readInputFile(std::string const &filePath)
     return inputData;
 }
 
+InputData readInputFile(std::string const &filePath)
+{
+    aoc::InputFile file(filePath);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open file " << filePath << std::endl;
+        return {};
+    }
+
+    return parseInput(file.contents());
+}
+
+bool isFresh(const std::pmr::deque<IdRange> &freshIds, Id id)
+{
+    for (const auto &range : freshIds)
+    {
+        if (id >= range.first && id <= range.second)
+        {
+            AOC_TRACE(aoc::TraceLevel::VERBOSE, "ID " << id << " is fresh (in range " << range.first << "-" << range.second << ")");
+            return true;
+        }
+    }
+    return false;
+}
+
 size_t countFreshIds(const InputData &inputData)
 {
     size_t count = 0;
     for (const auto &id : inputData.availableIds)
     {
-        bool isFresh = false;
-        for (const auto &range : inputData.freshIds)
+        if (isFresh(inputData.freshIds, id))
         {
-            if (id >= range.first && id <= range.second)
-            {
-                isFresh = true;
-                std::cout << "ID " << id << " is fresh (in range " << range.first << "-" << range.second << ")" << std::endl;
-                break;
-            }
+            count++;
         }
-        if (isFresh)
+    }
+    return count;
+}
+
+// Splits the input at its blank line into the range section and the queries
+std::pair<std::string_view, std::string_view> splitSections(std::string_view input)
+{
+    for (std::string_view line : aoc::LineRange(input))
+    {
+        if (line.empty())
         {
-            count++;
+            size_t blank = line.data() - input.data();
+            return {input.substr(0, blank), input.substr(blank + 1)};
         }
     }
+    return {input, {}};
+}
+
+// Fresh IDs among the queries in a chunk of whole lines
+size_t countFreshInChunk(const std::pmr::deque<IdRange> &freshIds, std::string_view chunk)
+{
+    size_t count = 0;
+    for (std::string_view line : aoc::LineRange(chunk))
+    {
+        if (line.empty())
+            continue;
+
+        Id id = 0;
+        aoc::parseUnsigned(line.data(), line.data() + line.size(), id);
+        count += isFresh(freshIds, id);
+    }
+    return count;
+}
+
+// Part 1 without materializing the queries: the ranges are loaded first, then
+// the query section runs through the pipeline chunk by chunk
+size_t countFreshQueries(const std::pmr::deque<IdRange> &freshIds, aoc::ChunkSource &queries)
+{
+    size_t count = 0;
+    aoc::runPipeline(
+        queries, [&](std::string_view chunk)
+        { return countFreshInChunk(freshIds, chunk); },
+        [&](size_t chunkCount)
+        { count += chunkCount; });
     return count;
 }
 
-bool removeOverlappingRanges(std::deque<IdRange> &ranges)
+size_t processQueries(std::string const &filePath)
+{
+    aoc::InputFile file(filePath);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open file " << filePath << std::endl;
+        return 0;
+    }
+
+    auto [rangeSection, querySection] = splitSections(file.contents());
+    InputData ranges = parseInput(rangeSection);
+    aoc::ChunkSource queries(querySection);
+    return countFreshQueries(ranges.freshIds, queries);
+}
+
+bool removeOverlappingRanges(std::pmr::deque<IdRange> &ranges)
 {
     bool removedAny = false;
     for (auto it = ranges.begin(); it != ranges.end(); ++it)
@@ -106,7 +188,7 @@ bool removeOverlappingRanges(std::deque<IdRange> &ranges)
     return removedAny;
 }
 
-size_t stripAndCountTotalFreshIds(std::deque<IdRange> &freshIds)
+size_t stripAndCountTotalFreshIds(std::pmr::deque<IdRange> &freshIds)
 {
     while (removeOverlappingRanges(freshIds))
     {
@@ -117,15 +199,107 @@ size_t stripAndCountTotalFreshIds(std::deque<IdRange> &freshIds)
     for (const auto &range : freshIds)
     {
         total += (range.second - range.first + 1);
-        std::cout << "Fresh ID range: " << range.first << "-" << range.second << " : Count " << (range.second - range.first + 1) << std::endl;
+        AOC_TRACE(aoc::TraceLevel::DEBUG, "Fresh ID range: " << range.first << "-" << range.second << " : Count " << (range.second - range.first + 1));
     }
     return total;
 }
 
-int main()
+// Input piped to stdin: the range section is read up to the blank line and
+// kept, the queries after it stream through the pipeline
+int streamInput(const aoc::StreamOptions &options)
 {
+    aoc::ChunkSource source(STDIN_FILENO, options.chunkBytes);
+    std::string rangeSection, storage;
+    std::string_view chunk, firstQueries;
+    bool blankLineFound = false;
+    while (!blankLineFound && source.next(storage, chunk))
+    {
+        auto [ranges, queries] = splitSections(chunk);
+        rangeSection.append(ranges);
+        blankLineFound = ranges.size() < chunk.size();
+        firstQueries = queries;
+    }
+
+    InputData inputData = parseInput(rangeSection);
+    if (aoc::streamsPart(options, 1))
+    {
+        size_t freshCount = countFreshInChunk(inputData.freshIds, firstQueries);
+        aoc::runStreaming(
+            source, options, [&](std::string_view queries)
+            { return countFreshInChunk(inputData.freshIds, queries); },
+            [&](size_t chunkCount)
+            { freshCount += chunkCount; },
+            [&](size_t bytes)
+            { std::cout << "After " << bytes << " bytes of queries: part 1 " << freshCount << std::endl; });
+        std::cout << "Total: part 1 " << freshCount << std::endl;
+    }
+    if (aoc::streamsPart(options, 2))
+        std::cout << "Total: part 2 " << stripAndCountTotalFreshIds(inputData.freshIds) << std::endl;
+    return 0;
+}
+
+// Binary cache columns: range starts, range ends (ranges sorted by start) and
+// the available IDs
+void storeParsed(aoc::ParsedInput &parsed, aoc::CacheWriter &cache)
+{
+    const auto &inputData = aoc::parsedData<InputData>(parsed);
+    std::vector<IdRange> ranges(inputData.freshIds.begin(), inputData.freshIds.end());
+    std::sort(ranges.begin(), ranges.end());
+
+    std::vector<Id> starts, ends;
+    for (const auto &range : ranges)
+    {
+        starts.push_back(range.first);
+        ends.push_back(range.second);
+    }
+    cache.addColumn<Id>(starts);
+    cache.addColumn<Id>(ends);
+    cache.addColumn<Id>(inputData.availableIds);
+}
+
+std::unique_ptr<aoc::ParsedInput> loadParsed(const aoc::CacheFile &cache)
+{
+    auto starts = cache.column<Id>(0);
+    auto ends = cache.column<Id>(1);
+    auto availableIds = cache.column<Id>(2);
+    if (cache.columnCount() != 3U || starts.size() != ends.size())
+        return nullptr;
+
+    return aoc::makeLoaded(cache, [&](const aoc::CacheFile &, std::pmr::memory_resource *memory)
+                           {
+        InputData inputData{std::pmr::deque<IdRange>(memory), std::pmr::vector<Id>(availableIds.begin(), availableIds.end(), memory)};
+        for (size_t i = 0; i < starts.size(); ++i)
+            inputData.freshIds.emplace_back(starts[i], ends[i]);
+        return inputData; });
+}
+
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int /* part */)
+{
+    return aoc::makeParsed(input, parseInput);
+}
+
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part)
+{
+    auto &inputData = aoc::parsedData<InputData>(parsed);
+    return part == 1 ? countFreshIds(inputData) : stripAndCountTotalFreshIds(inputData.freshIds);
+}
+
+} // namespace day05
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv)
+{
+    using namespace day05;
+
+    auto streamOptions = aoc::parseStreamOptions(argc, argv);
+    if (streamOptions.enabled)
+        return streamOptions.valid ? streamInput(streamOptions) : 1;
+
+    std::cout << "Number of available fresh IDs: " << processQueries("input/input.txt") << std::endl;
+
     auto inputData = readInputFile("input/input.txt");
     size_t freshCount = stripAndCountTotalFreshIds(inputData.freshIds);
     std::cout << "Number of fresh IDs: " << freshCount << std::endl;
     return 0;
 }
+#endif
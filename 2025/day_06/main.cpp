@@ -1,30 +1,34 @@
+#include <cctype>
 #include <deque>
-#include <fstream>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "common/input_reader.hpp"
+#include "common/parse.hpp"
+#include "common/solver.hpp"
+#include "common/trace.hpp"
+
+namespace day06
+{
+
 class ProblemData
 {
 public:
     char operand;
-    std::vector<int> numbers;
+    std::pmr::vector<int> numbers;
 };
 
-std::vector<ProblemData> readInputFilePart1(std::string const &filePath)
-{
-    std::vector<ProblemData> data;
-    std::ifstream file(filePath);
-
-    if (!file.is_open())
-    {
-        std::cerr << "Error: Could not open file " << filePath << std::endl;
-        return data;
-    }
+using ProblemList = std::pmr::vector<ProblemData>;
 
-    std::string line;
-    while (std::getline(file, line))
+ProblemList parseInputPart1(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+{
+    ProblemList data(memory);
+    for (std::string_view line : aoc::LineRange(input))
     {
         if (line.empty())
             continue;
@@ -45,12 +49,12 @@ std::vector<ProblemData> readInputFilePart1(std::string const &filePath)
                 break;
 
             size_t spacePos = line.find(' ', pos);
-            if (spacePos == std::string::npos)
+            if (spacePos == std::string_view::npos)
                 spacePos = line.length();
 
             if (index >= data.size())
             {
-                data.push_back(ProblemData{});
+                data.push_back(ProblemData{'\0', std::pmr::vector<int>(memory)});
             }
 
             auto subStr = line.substr(pos, spacePos - pos);
@@ -62,14 +66,14 @@ std::vector<ProblemData> readInputFilePart1(std::string const &filePath)
                 continue;
             }
 
-            std::cout << "Read substring: '" << subStr << "'" << std::endl;
+            AOC_TRACE(aoc::TraceLevel::VERBOSE, "Read substring: '" << subStr << "'");
             if (operandLine)
             {
                 data[index].operand = subStr[0];
             }
             else
             {
-                int number = std::stoi(subStr);
+                int number = aoc::toNumber<int>(subStr);
                 data[index].numbers.push_back(number);
             }
 
@@ -78,24 +82,14 @@ std::vector<ProblemData> readInputFilePart1(std::string const &filePath)
         }
     }
 
-    file.close();
     return data;
 }
 
-std::vector<ProblemData> readInputFilePart2(std::string const &filePath)
+ProblemList parseInputPart2(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
 {
-    std::vector<ProblemData> data;
-    std::ifstream file(filePath);
-
-    if (!file.is_open())
-    {
-        std::cerr << "Error: Could not open file " << filePath << std::endl;
-        return data;
-    }
-
-    std::string line;
-    std::vector<std::string> lines;
-    while (std::getline(file, line))
+    ProblemList data(memory);
+    std::vector<std::string_view> lines;
+    for (std::string_view line : aoc::LineRange(input))
     {
         if (line.empty())
             continue;
@@ -103,6 +97,9 @@ std::vector<ProblemData> readInputFilePart2(std::string const &filePath)
         lines.push_back(line);
     }
 
+    if (lines.empty())
+        return data;
+
     size_t lineCount = lines.size();
     size_t lineLength = lines[0].length();
 
@@ -116,7 +113,7 @@ std::vector<ProblemData> readInputFilePart2(std::string const &filePath)
             char ch = lines[j][i];
             if (j == lineCount - 1 && !allEmpty)
             {
-                std::cout << "Read number: " << number << " at line " << j << std::endl;
+                AOC_TRACE(aoc::TraceLevel::VERBOSE, "Read number: " << number << " at line " << j);
                 problemNumbers.push_back(number);
             }
 
@@ -127,20 +124,39 @@ std::vector<ProblemData> readInputFilePart2(std::string const &filePath)
             }
             else if (ch == '+' || ch == '*')
             {
-                ProblemData problem;
-                problem.operand = ch;
-                problem.numbers = problemNumbers;
-                data.push_back(problem);
+                data.push_back(ProblemData{ch, std::pmr::vector<int>(problemNumbers.begin(), problemNumbers.end(), memory)});
                 problemNumbers.clear();
             }
         }
     }
 
-    file.close();
     return data;
 }
 
-long long computeResult(const std::vector<ProblemData> &problems)
+ProblemList readInputFile(std::string const &filePath, ProblemList (*parser)(std::string_view, std::pmr::memory_resource *))
+{
+    aoc::InputFile file(filePath);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open file " << filePath << std::endl;
+        return {};
+    }
+
+    return parser(file.contents(), std::pmr::get_default_resource());
+}
+
+ProblemList readInputFilePart1(std::string const &filePath)
+{
+    return readInputFile(filePath, parseInputPart1);
+}
+
+ProblemList readInputFilePart2(std::string const &filePath)
+{
+    return readInputFile(filePath, parseInputPart2);
+}
+
+long long computeResult(const ProblemList &problems)
 {
     long long result = 0;
     for (const auto &problem : problems)
@@ -157,16 +173,32 @@ long long computeResult(const std::vector<ProblemData> &problems)
                 partialResult *= number;
             }
         }
-        std::cout << "Partial result for operand " << problem.operand << ": " << partialResult << std::endl;
+        AOC_TRACE(aoc::TraceLevel::DEBUG, "Partial result for operand " << problem.operand << ": " << partialResult);
         result += partialResult;
     }
     return result;
 }
 
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int part)
+{
+    return aoc::makeParsed(input, part == 1 ? parseInputPart1 : parseInputPart2);
+}
+
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int /* part */)
+{
+    return computeResult(aoc::parsedData<ProblemList>(parsed));
+}
+
+} // namespace day06
+
+#ifndef AOC_RUNNER
 int main()
 {
+    using namespace day06;
+
     auto inputData = readInputFilePart2("input/input.txt");
     auto result = computeResult(inputData);
     std::cout << "Total result: " << result << std::endl;
     return 0;
 }
+#endif
@@ -1,108 +1,320 @@
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <deque>
-#include <fstream>
 #include <iostream>
-#include <set>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "common/cpu_dispatch.hpp"
+#include "common/grid.hpp"
+#include "common/input_reader.hpp"
+#include "common/pipeline.hpp"
+#include "common/solver.hpp"
+#include "common/stream.hpp"
+
+namespace day07
+{
+
+// Splitter rows below the start line, one bit per position
 class ProblemData
 {
 public:
     size_t initialPosition;
-    std::vector<std::set<size_t>> splitters;
+    aoc::Grid<bool> splitters;
 };
 
-ProblemData readInputFile(std::string const &filePath)
+// Splitter grid of the given lines; rows are as wide as the widest line
+aoc::Grid<bool> parseSplitterRows(const std::vector<std::string_view> &lines,
+                                  std::pmr::memory_resource *memory = std::pmr::get_default_resource())
 {
-    ProblemData data;
-    std::ifstream file(filePath);
+    size_t width = 0U;
+    for (std::string_view line : lines)
+    {
+        width = std::max(width, line.size());
+    }
 
-    if (!file.is_open())
+    aoc::Grid<bool> splitters(lines.size(), width, 1U, memory);
+    for (size_t r = 0; r < lines.size(); ++r)
     {
-        std::cerr << "Error: Could not open file " << filePath << std::endl;
-        return data;
+        for (size_t i = 0; i < lines[r].length(); i++)
+        {
+            if (lines[r][i] == '^')
+            {
+                splitters.set(r, i);
+            }
+        }
     }
+    return splitters;
+}
 
-    std::string line;
+ProblemData parseInput(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+{
+    ProblemData data{0U, aoc::Grid<bool>(0U, 0U, 1U, memory)};
+    auto lines = aoc::LineRange(input);
+    auto lineIt = lines.begin();
+    if (lineIt == lines.end())
+        return data;
 
     // First line contains the initial position
-    std::getline(file, line);
-    data.initialPosition = line.find('S');
+    data.initialPosition = lineIt->find('S');
 
-    while (std::getline(file, line))
+    std::vector<std::string_view> rows;
+    for (++lineIt; lineIt != lines.end(); ++lineIt)
     {
+        std::string_view line = *lineIt;
         if (line.empty())
             continue;
 
-        std::set<size_t> splitterPositions;
-        for (size_t i = 0; i < line.length(); i++)
-        {
-            if (line[i] == '^')
-            {
-                splitterPositions.insert(i);
-            }
-        }
-        data.splitters.push_back(splitterPositions);
+        rows.push_back(line);
     }
+    data.splitters = parseSplitterRows(rows, memory);
 
-    file.close();
     return data;
 }
 
-std::pair<size_t, size_t> processInput(const ProblemData &data)
+ProblemData readInputFile(std::string const &filePath)
 {
-    size_t totalNumberOfSplits = 0U;
-    std::unordered_map<size_t, size_t> activeBeams = {{data.initialPosition, 1U}};
+    aoc::InputFile file(filePath);
 
-    for (const auto &splitterRow : data.splitters)
+    if (!file.isOpen())
     {
-        std::unordered_map<size_t, size_t> nextActiveBeam;
+        std::cerr << "Error: Could not open file " << filePath << std::endl;
+        return {};
+    }
+
+    return parseInput(file.contents());
+}
 
-        for (const auto &activeBeam : activeBeams)
+// Moves the beam counts of positions [0, width) through one splitter row and
+// returns how many beams were split. `mask` is all ones at a splitter and zero
+// elsewhere. All three rows have one position past either end, where `mask`
+// is zero: a splitter in the first or last column sends a beam there, off the
+// diagram, and it goes on counting as a timeline (".S.", "...", ".^.", "...",
+// "^.^" ends with 4 timelines, one of them at -1 and one at width).
+template <size_t VECTOR_BYTES>
+AOC_ALWAYS_INLINE uint64_t propagateBeamsBody(const uint64_t *current, const uint64_t *mask, uint64_t *next, size_t width)
+{
+    using Vector = aoc::cpu::Vector<uint64_t, VECTOR_BYTES>;
+    using Flags = aoc::cpu::Vector<int64_t, VECTOR_BYTES>;
+    constexpr size_t LANES = VECTOR_BYTES / sizeof(uint64_t);
+
+    // A beam goes straight on unless it hits a splitter, which sends it to
+    // both neighbours
+    Flags splitLanes = {};
+    size_t c = 0;
+    for (; c + LANES <= width; c += LANES)
+    {
+        Vector beams, splitters, left, leftSplitters, right, rightSplitters;
+        std::memcpy(&beams, current + c, VECTOR_BYTES);
+        std::memcpy(&splitters, mask + c, VECTOR_BYTES);
+        std::memcpy(&left, current + c - 1, VECTOR_BYTES);
+        std::memcpy(&leftSplitters, mask + c - 1, VECTOR_BYTES);
+        std::memcpy(&right, current + c + 1, VECTOR_BYTES);
+        std::memcpy(&rightSplitters, mask + c + 1, VECTOR_BYTES);
+        Vector merged = (beams & ~splitters) + (left & leftSplitters) + (right & rightSplitters);
+        std::memcpy(next + c, &merged, VECTOR_BYTES);
+        splitLanes -= (beams & splitters) != 0;
+    }
+
+    uint64_t splits = 0U;
+    for (size_t lane = 0; lane < LANES; ++lane)
+    {
+        splits += splitLanes[lane];
+    }
+    for (; c < width; ++c)
+    {
+        next[c] = (current[c] & ~mask[c]) + (current[c - 1] & mask[c - 1]) + (current[c + 1] & mask[c + 1]);
+        splits += (current[c] & mask[c]) != 0U;
+    }
+
+    // Beams off either edge go straight on; splitters only reach them
+    next[-1] = current[-1] + (current[0] & mask[0]);
+    next[width] = current[width] + (current[width - 1] & mask[width - 1]);
+    return splits;
+}
+
+using PropagateBeamsKernel = uint64_t (*)(const uint64_t *, const uint64_t *, uint64_t *, size_t);
+
+uint64_t propagateBeamsBaseline(const uint64_t *current, const uint64_t *mask, uint64_t *next, size_t width)
+{
+    return propagateBeamsBody<aoc::cpu::BASELINE_VECTOR_BYTES>(current, mask, next, width);
+}
+
+AOC_TARGET_SSE42 uint64_t propagateBeamsSse42(const uint64_t *current, const uint64_t *mask, uint64_t *next, size_t width)
+{
+    return propagateBeamsBody<aoc::cpu::SSE42_VECTOR_BYTES>(current, mask, next, width);
+}
+
+AOC_TARGET_AVX2 uint64_t propagateBeamsAvx2(const uint64_t *current, const uint64_t *mask, uint64_t *next, size_t width)
+{
+    return propagateBeamsBody<aoc::cpu::AVX2_VECTOR_BYTES>(current, mask, next, width);
+}
+
+AOC_TARGET_AVX512 uint64_t propagateBeamsAvx512(const uint64_t *current, const uint64_t *mask, uint64_t *next, size_t width)
+{
+    return propagateBeamsBody<aoc::cpu::AVX512_VECTOR_BYTES>(current, mask, next, width);
+}
+
+// Beams moving down the diagram one splitter row at a time, as a dense row of
+// beam counts per position
+class BeamTracker
+{
+public:
+    explicit BeamTracker(size_t initialPosition)
+        : propagate_(aoc::cpu::select<PropagateBeamsKernel>(propagateBeamsBaseline, propagateBeamsSse42,
+                                                            propagateBeamsAvx2, propagateBeamsAvx512))
+    {
+        resize(initialPosition + 1U);
+        beams_(0, static_cast<ptrdiff_t>(initialPosition)) = 1U;
+    }
+
+    // Moves the beams through row r of the splitter grid
+    void advance(const aoc::Grid<bool> &splitters, size_t r)
+    {
+        // A split beam lands one past the splitter, which must be tracked too
+        if (splitters.cols() + 1U > width_)
+            resize(splitters.cols() + 1U);
+
+        std::ranges::fill(mask_.row(0), 0U);
+        splitters.forEachSet(r, [&](ptrdiff_t position)
+                             { mask_(0, position) = ~uint64_t{0}; });
+
+        totalNumberOfSplits_ += propagate_(beams_.rowData(0), mask_.rowData(0), next_.rowData(0), width_);
+        std::swap(beams_, next_);
+    }
+
+    size_t splits() const { return totalNumberOfSplits_; }
+
+    // Beams in the halo left the diagram but still count as timelines
+    size_t timeLines() const
+    {
+        size_t totalTimeLines = 0U;
+        for (ptrdiff_t c = -1; c <= static_cast<ptrdiff_t>(width_); ++c)
         {
-            auto addBeam = [&](size_t pos)
-            {
-                auto it = nextActiveBeam.find(pos);
-                if (it == nextActiveBeam.end())
-                {
-                    nextActiveBeam.emplace(pos, activeBeam.second);
-                }
-                else
-                {
-                    it->second += activeBeam.second;
-                }
-            };
-
-            if (splitterRow.find(activeBeam.first) != splitterRow.end())
-            {
-                addBeam(activeBeam.first - 1U);
-                addBeam(activeBeam.first + 1U);
-                totalNumberOfSplits++;
-            }
-            else
-            {
-                addBeam(activeBeam.first);
-            }
+            totalTimeLines += beams_(0, c);
         }
+        return totalTimeLines;
+    }
+
+private:
+    // Widens the rows, keeping the beams; the old right halo cell becomes an
+    // ordinary position
+    void resize(size_t width)
+    {
+        aoc::Grid<uint64_t> beams(1U, width);
+        if (width_ != 0U)
+            std::copy_n(beams_.rowData(0) - 1, width_ + 2U, beams.rowData(0) - 1);
+        width_ = width;
+        beams_ = std::move(beams);
+        next_ = aoc::Grid<uint64_t>(1U, width);
+        mask_ = aoc::Grid<uint64_t>(1U, width);
+    }
+
+    PropagateBeamsKernel propagate_;
+    size_t width_ = 0U;
+    // Single rows with a one-cell halo, which the kernel reads and writes as
+    // positions -1 and width
+    aoc::Grid<uint64_t> beams_;
+    aoc::Grid<uint64_t> next_;
+    aoc::Grid<uint64_t> mask_;
+    size_t totalNumberOfSplits_ = 0U;
+};
 
-        activeBeams = std::move(nextActiveBeam);
+std::pair<size_t, size_t> processInput(const ProblemData &data)
+{
+    BeamTracker beams(data.initialPosition);
+    for (size_t r = 0; r < data.splitters.rows(); ++r)
+    {
+        beams.advance(data.splitters, r);
     }
+    return {beams.splits(), beams.timeLines()};
+}
 
-    size_t totalTimeLines = 0U;
-    for (const auto &activeBeam : activeBeams)
+// Rows of one chunk of a streamed diagram. The start line is recognised by its
+// 'S' since a chunk does not know whether it comes first.
+ProblemData parseRows(std::string_view chunk)
+{
+    size_t initialPosition = std::string_view::npos;
+    std::vector<std::string_view> lines;
+    for (std::string_view line : aoc::LineRange(chunk))
     {
-        totalTimeLines += activeBeam.second;
+        if (line.empty())
+            continue;
+
+        size_t start = initialPosition == std::string_view::npos ? line.find('S') : std::string_view::npos;
+        if (start != std::string_view::npos)
+            initialPosition = start;
+        else
+            lines.push_back(line);
     }
+    return {initialPosition, parseSplitterRows(lines)};
+}
+
+// Diagram piped to stdin: rows are parsed on the pool chunk by chunk and the
+// beams advance through them in order, so only the beam front is kept
+int streamInput(const aoc::StreamOptions &options)
+{
+    std::optional<BeamTracker> beams;
+    auto printTotals = [&](const std::string &label)
+    {
+        std::cout << label << ":";
+        if (aoc::streamsPart(options, 1))
+            std::cout << " part 1 " << (beams ? beams->splits() : 0U);
+        if (aoc::streamsPart(options, 2))
+            std::cout << " part 2 " << (beams ? beams->timeLines() : 0U);
+        std::cout << std::endl;
+    };
 
-    return {totalNumberOfSplits, totalTimeLines};
+    aoc::ChunkSource source(STDIN_FILENO, options.chunkBytes);
+    aoc::runStreaming(
+        source, options, parseRows,
+        [&](ProblemData &&rows)
+        {
+            if (!beams && rows.initialPosition != std::string_view::npos)
+                beams.emplace(rows.initialPosition);
+            if (!beams)
+                return;
+            for (size_t r = 0; r < rows.splitters.rows(); ++r)
+                beams->advance(rows.splitters, r);
+        },
+        [&](size_t bytes)
+        { printTotals("After " + std::to_string(bytes) + " bytes"); });
+    printTotals("Total");
+    return 0;
+}
+
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int /* part */)
+{
+    return aoc::makeParsed(input, parseInput);
+}
+
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part)
+{
+    auto result = processInput(aoc::parsedData<ProblemData>(parsed));
+    return part == 1 ? result.first : result.second;
 }
-int main()
+
+} // namespace day07
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv)
 {
+    using namespace day07;
+
+    auto streamOptions = aoc::parseStreamOptions(argc, argv);
+    if (streamOptions.enabled)
+        return streamOptions.valid ? streamInput(streamOptions) : 1;
+
     auto inputData = readInputFile("input/input.txt");
     auto result = processInput(inputData);
     std::cout << "Total number of splits: " << result.first << std::endl;
     std::cout << "Total time lines: " << result.second << std::endl;
     return 0;
 }
+#endif
@@ -1,13 +1,28 @@
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <deque>
-#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <set>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/cpu_dispatch.hpp"
+#include "common/huge_pages.hpp"
+#include "common/input_reader.hpp"
+#include "common/parse.hpp"
+#include "common/solver.hpp"
+#include "common/trace.hpp"
+
+namespace day08
+{
+
 class Coordinates
 {
 public:
@@ -16,6 +31,8 @@ public:
     int z;
 };
 
+using Points = std::pmr::vector<Coordinates>;
+
 class Distance
 {
 public:
@@ -30,51 +47,124 @@ public:
     }
 };
 
-std::vector<Coordinates>
-readInputFile(std::string const &filePath)
+Points
+parseInput(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
 {
-    std::vector<Coordinates> data;
-    std::ifstream file(filePath);
-
-    if (!file.is_open())
-    {
-        std::cerr << "Error: Could not open file " << filePath << std::endl;
-        return data;
-    }
-
-    std::string line;
-    while (std::getline(file, line))
+    Points data(memory);
+    for (std::string_view line : aoc::LineRange(input))
     {
         if (line.empty())
             continue;
 
         // parse coordinates in format x,y,z
-        size_t firstComma = line.find(',');
-        size_t secondComma = line.find(',', firstComma + 1);
-        if (firstComma == std::string::npos || secondComma == std::string::npos)
+        const char *end = line.data() + line.size();
+        int x = 0;
+        int y = 0;
+        int z = 0;
+        const char *cursor = aoc::parseSigned(line.data(), end, x);
+        if (cursor >= end || *cursor != ',')
             continue;
-
-        int x = std::stoi(line.substr(0, firstComma));
-        int y = std::stoi(line.substr(firstComma + 1, secondComma - firstComma - 1));
-        int z = std::stoi(line.substr(secondComma + 1));
+        cursor = aoc::parseSigned(cursor + 1, end, y);
+        if (cursor >= end || *cursor != ',')
+            continue;
+        aoc::parseSigned(cursor + 1, end, z);
         data.push_back({x, y, z});
     }
 
-    file.close();
     return data;
 }
 
-std::vector<Distance> calculateDistances(const std::vector<Coordinates> &points)
+Points
+readInputFile(std::string const &filePath)
 {
-    std::vector<Distance> distances;
-    for (size_t i = 0; i < points.size(); i++)
+    aoc::InputFile file(filePath);
+
+    if (!file.isOpen())
     {
-        for (size_t j = i + 1; j < points.size(); j++)
+        std::cerr << "Error: Could not open file " << filePath << std::endl;
+        return {};
+    }
+
+    return parseInput(file.contents());
+}
+
+// Squared distances from (x, y, z) to the first `count` points of the
+// coordinate columns. Coordinates are integers well below 2^26, so every
+// product and sum is exact in double and all variants agree bit for bit.
+template <size_t VECTOR_BYTES>
+AOC_ALWAYS_INLINE void squaredDistancesBody(const double *xs, const double *ys, const double *zs, size_t count,
+                                            double x, double y, double z, double *out)
+{
+    using Vector = aoc::cpu::Vector<double, VECTOR_BYTES>;
+    constexpr size_t LANES = VECTOR_BYTES / sizeof(double);
+
+    size_t j = 0;
+    for (; j + LANES <= count; j += LANES)
+    {
+        Vector vx, vy, vz;
+        std::memcpy(&vx, xs + j, VECTOR_BYTES);
+        std::memcpy(&vy, ys + j, VECTOR_BYTES);
+        std::memcpy(&vz, zs + j, VECTOR_BYTES);
+        Vector dx = vx - x, dy = vy - y, dz = vz - z;
+        Vector squared = dx * dx + dy * dy + dz * dz;
+        std::memcpy(out + j, &squared, VECTOR_BYTES);
+    }
+    for (; j < count; ++j)
+    {
+        double dx = xs[j] - x, dy = ys[j] - y, dz = zs[j] - z;
+        out[j] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+using SquaredDistancesKernel = void (*)(const double *, const double *, const double *, size_t, double, double, double, double *);
+
+void squaredDistancesBaseline(const double *xs, const double *ys, const double *zs, size_t count, double x, double y, double z, double *out)
+{
+    squaredDistancesBody<aoc::cpu::BASELINE_VECTOR_BYTES>(xs, ys, zs, count, x, y, z, out);
+}
+
+AOC_TARGET_SSE42 void squaredDistancesSse42(const double *xs, const double *ys, const double *zs, size_t count, double x, double y, double z, double *out)
+{
+    squaredDistancesBody<aoc::cpu::SSE42_VECTOR_BYTES>(xs, ys, zs, count, x, y, z, out);
+}
+
+AOC_TARGET_AVX2 void squaredDistancesAvx2(const double *xs, const double *ys, const double *zs, size_t count, double x, double y, double z, double *out)
+{
+    squaredDistancesBody<aoc::cpu::AVX2_VECTOR_BYTES>(xs, ys, zs, count, x, y, z, out);
+}
+
+AOC_TARGET_AVX512 void squaredDistancesAvx512(const double *xs, const double *ys, const double *zs, size_t count, double x, double y, double z, double *out)
+{
+    squaredDistancesBody<aoc::cpu::AVX512_VECTOR_BYTES>(xs, ys, zs, count, x, y, z, out);
+}
+
+using Distances = std::pmr::vector<Distance>;
+
+Distances calculateDistances(const Points &points)
+{
+    // Coordinate columns for the kernel
+    size_t count = points.size();
+    std::vector<double> xs(count), ys(count), zs(count), squared(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        xs[i] = points[i].x;
+        ys[i] = points[i].y;
+        zs[i] = points[i].z;
+    }
+
+    SquaredDistancesKernel squaredDistances = aoc::cpu::select<SquaredDistancesKernel>(
+        squaredDistancesBaseline, squaredDistancesSse42, squaredDistancesAvx2, squaredDistancesAvx512);
+
+    // All pairs: the largest table of the day, sized up front so it is one
+    // block, huge-page backed when that is enabled
+    Distances distances(aoc::largeTableResource());
+    distances.reserve(count * (count - (count > 0U)) / 2U);
+    for (size_t i = 0; i < count; i++)
+    {
+        squaredDistances(xs.data() + i + 1, ys.data() + i + 1, zs.data() + i + 1, count - i - 1, xs[i], ys[i], zs[i], squared.data());
+        for (size_t j = i + 1; j < count; j++)
         {
-            double dist = std::sqrt(std::pow(points[i].x - points[j].x, 2) +
-                                    std::pow(points[i].y - points[j].y, 2) +
-                                    std::pow(points[i].z - points[j].z, 2));
-            distances.push_back({dist, {i, j}, points[i], points[j]});
+            distances.push_back({std::sqrt(squared[j - i - 1]), {i, j}, points[i], points[j]});
         }
     }
 
@@ -88,7 +178,7 @@ using NodeToCircuitMapping = std::unordered_map<size_t, size_t>; // Maps node to
 
 void connectTwoNodes(NodeToCircuitMapping &nodeToCircuitMapping, CircuitNodes &circuitNodes, size_t node1, size_t node2)
 {
-    // std::cout << "Evaluating the connection of nodes " << node1 << " and " << node2 << std::endl;
+    AOC_TRACE(aoc::TraceLevel::VERBOSE, "Evaluating the connection of nodes " << node1 << " and " << node2);
     size_t targetCircuitIndex;
     auto node1Mapping = nodeToCircuitMapping.find(node1);
     auto node2Mapping = nodeToCircuitMapping.find(node2);
@@ -100,7 +190,7 @@ void connectTwoNodes(NodeToCircuitMapping &nodeToCircuitMapping, CircuitNodes &c
 
         if (circuitIndex1 == circuitIndex2)
         {
-            // std::cout << "Both nodes are already in the same circuit." << std::endl;
+            AOC_TRACE(aoc::TraceLevel::VERBOSE, "Both nodes are already in the same circuit.");
             return; // already in the same circuit
         }
     }
@@ -114,7 +204,7 @@ void connectTwoNodes(NodeToCircuitMapping &nodeToCircuitMapping, CircuitNodes &c
     }
     else
     {
-        // std::cout << "Connecting nodes " << node1 << " and " << node2 << " into a new circuit." << std::endl;
+        AOC_TRACE(aoc::TraceLevel::VERBOSE, "Connecting nodes " << node1 << " and " << node2 << " into a new circuit.");
         // create new circuit
         circuitNodes.push_back({node1, node2});
         targetCircuitIndex = circuitNodes.size() - 1;
@@ -129,13 +219,13 @@ void connectTwoNodes(NodeToCircuitMapping &nodeToCircuitMapping, CircuitNodes &c
         if (nodeMapping == nodeToCircuitMapping.end())
         {
             // node is not yet in a circuit, just add it
-            // std::cout << "Adding node " << node << " to existing circuit " << targetCircuitIndex << std::endl;
+            AOC_TRACE(aoc::TraceLevel::VERBOSE, "Adding node " << node << " to existing circuit " << targetCircuitIndex);
             circuitNodes[targetCircuitIndex].push_back(node);
             nodeToCircuitMapping[node] = targetCircuitIndex;
         }
         else
         {
-            // std::cout << "Merging circuit of node " << node << " into circuit " << targetCircuitIndex << std::endl;
+            AOC_TRACE(aoc::TraceLevel::VERBOSE, "Merging circuit of node " << node << " into circuit " << targetCircuitIndex);
             // node is already in a circuit, need to merge circuits
             size_t sourceCircuitIndex = nodeMapping->second;
 
@@ -169,7 +259,7 @@ size_t countNodesInSingleCircuit(const CircuitNodes &circuitNodes)
     return 0U;
 }
 
-long long connectJunctionBoxes(const std::vector<Coordinates> &inputData, const std::vector<Distance> &distances, bool part1 = true)
+long long connectJunctionBoxes(const Points &inputData, const Distances &distances, bool part1 = true)
 {
     std::vector<std::vector<size_t>> circuitNodes;
     std::unordered_map<size_t, size_t> nodeToCircuitMapping; // Map node to circuit index
@@ -191,9 +281,9 @@ long long connectJunctionBoxes(const std::vector<Coordinates> &inputData, const
         {
             if (countNodesInSingleCircuit(circuitNodes) == inputData.size())
             {
-                std::cout << "All node connected after processing " << connectedNodes << " connections." << std::endl;
-                std::cout << "Last connection was between points (" << distance.point1.x << "," << distance.point1.y << "," << distance.point1.z << ") and ("
-                          << distance.point2.x << "," << distance.point2.y << "," << distance.point2.z << ")" << std::endl;
+                AOC_TRACE(aoc::TraceLevel::INFO, "All node connected after processing " << connectedNodes << " connections.");
+                AOC_TRACE(aoc::TraceLevel::INFO, "Last connection was between points (" << distance.point1.x << "," << distance.point1.y << "," << distance.point1.z << ") and ("
+                                                 << distance.point2.x << "," << distance.point2.y << "," << distance.point2.z << ")");
                 return static_cast<long long>(distance.point1.x) * distance.point2.x;
             }
         }
@@ -220,11 +310,62 @@ long long connectJunctionBoxes(const std::vector<Coordinates> &inputData, const
     return result;
 }
 
+// Binary cache columns: the x, y and z coordinates, one column each
+void storeParsed(aoc::ParsedInput &parsed, aoc::CacheWriter &cache)
+{
+    const auto &points = aoc::parsedData<Points>(parsed);
+    std::vector<int> xs, ys, zs;
+    for (const auto &point : points)
+    {
+        xs.push_back(point.x);
+        ys.push_back(point.y);
+        zs.push_back(point.z);
+    }
+    cache.addColumn<int>(xs);
+    cache.addColumn<int>(ys);
+    cache.addColumn<int>(zs);
+}
+
+std::unique_ptr<aoc::ParsedInput> loadParsed(const aoc::CacheFile &cache)
+{
+    auto xs = cache.column<int>(0);
+    auto ys = cache.column<int>(1);
+    auto zs = cache.column<int>(2);
+    if (cache.columnCount() != 3U || ys.size() != xs.size() || zs.size() != xs.size())
+        return nullptr;
+
+    return aoc::makeLoaded(cache, [&](const aoc::CacheFile &, std::pmr::memory_resource *memory)
+                           {
+        Points points(memory);
+        points.reserve(xs.size());
+        for (size_t i = 0; i < xs.size(); ++i)
+            points.push_back({xs[i], ys[i], zs[i]});
+        return points; });
+}
+
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int /* part */)
+{
+    return aoc::makeParsed(input, parseInput);
+}
+
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part)
+{
+    const auto &inputData = aoc::parsedData<Points>(parsed);
+    auto distances = calculateDistances(inputData);
+    return connectJunctionBoxes(inputData, distances, part == 1);
+}
+
+} // namespace day08
+
+#ifndef AOC_RUNNER
 int main()
 {
+    using namespace day08;
+
     auto inputData = readInputFile("input/input.txt");
     auto distances = calculateDistances(inputData);
     size_t numCircuits = connectJunctionBoxes(inputData, distances, false);
     std::cout << "Result: " << numCircuits << std::endl;
     return 0;
 }
+#endif
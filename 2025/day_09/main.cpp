@@ -1,13 +1,24 @@
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <deque>
-#include <fstream>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <set>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "common/input_reader.hpp"
+#include "common/parse.hpp"
+#include "common/solver.hpp"
+#include "common/thread_pool.hpp"
+
+namespace day09
+{
+
 class Coordinates
 {
 public:
@@ -15,40 +26,48 @@ public:
     uint32_t y;
 };
 
-std::vector<Coordinates>
-readInputFile(std::string const &filePath)
-{
-    std::vector<Coordinates> data;
-    std::ifstream file(filePath);
-
-    if (!file.is_open())
-    {
-        std::cerr << "Error: Could not open file " << filePath << std::endl;
-        return data;
-    }
+using Polygon = std::pmr::vector<Coordinates>;
 
-    std::string line;
-    while (std::getline(file, line))
+Polygon
+parseInput(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+{
+    Polygon data(memory);
+    for (std::string_view line : aoc::LineRange(input))
     {
         if (line.empty())
             continue;
 
         // parse coordinates in format x,y,z
-        size_t firstComma = line.find(',');
-        if (firstComma == std::string::npos)
+        const char *end = line.data() + line.size();
+        uint32_t x = 0;
+        uint32_t y = 0;
+        const char *cursor = aoc::parseUnsigned(line.data(), end, x);
+        if (cursor >= end || *cursor != ',')
             continue;
 
-        uint32_t x = std::stoul(line.substr(0, firstComma));
-        uint32_t y = std::stoul(line.substr(firstComma + 1));
+        aoc::parseUnsigned(cursor + 1, end, y);
         data.push_back({x, y});
     }
 
-    file.close();
     return data;
 }
 
+Polygon
+readInputFile(std::string const &filePath)
+{
+    aoc::InputFile file(filePath);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open file " << filePath << std::endl;
+        return {};
+    }
+
+    return parseInput(file.contents());
+}
+
 // Check if point is inside or on the boundary of the polygon using ray casting
-bool isInsideOrOnPolygon(const Coordinates &point, const std::vector<Coordinates> &polygon)
+bool isInsideOrOnPolygon(const Coordinates &point, const Polygon &polygon)
 {
     int n = polygon.size();
     bool inside = false;
@@ -77,7 +96,7 @@ bool isInsideOrOnPolygon(const Coordinates &point, const std::vector<Coordinates
 }
 
 // Check if entire rectangle is inside or on the polygon
-bool isRectangleValid(const Coordinates &c1, const Coordinates &c2, const std::vector<Coordinates> &polygon)
+bool isRectangleValid(const Coordinates &c1, const Coordinates &c2, const Polygon &polygon)
 {
     uint32_t minX = std::min(c1.x, c2.x);
     uint32_t maxX = std::max(c1.x, c2.x);
@@ -117,7 +136,7 @@ bool isRectangleValid(const Coordinates &c1, const Coordinates &c2, const std::v
     return true;
 }
 
-std::vector<uint64_t> calculateArea(const std::vector<Coordinates> &points)
+std::vector<uint64_t> calculateArea(const Polygon &points)
 {
     size_t numPoints = points.size();
     std::vector<uint64_t> areas;
@@ -134,28 +153,84 @@ std::vector<uint64_t> calculateArea(const std::vector<Coordinates> &points)
     return areas;
 }
 
-uint64_t calculateMaxAreaWithGreenTiles(const std::vector<Coordinates> &points)
+uint64_t calculateMaxAreaWithGreenTiles(const Polygon &points)
 {
-    uint64_t maxArea = 0;
-
-    for (size_t i = 0; i < points.size(); i++)
-    {
-        for (size_t j = i + 1; j < points.size(); j++)
+    // One task per first corner; later corners have fewer partners, and
+    // stealing evens out the triangular workload
+    return aoc::parallelReduce(
+        0U, points.size(), uint64_t{0},
+        [&](size_t i)
         {
-            if (isRectangleValid(points[i], points[j], points))
+            uint64_t maxArea = 0;
+            for (size_t j = i + 1; j < points.size(); j++)
             {
-                uint64_t area = static_cast<uint64_t>(std::abs(static_cast<int64_t>(points[i].x) - static_cast<int64_t>(points[j].x)) + 1U) *
-                                static_cast<uint64_t>(std::abs(static_cast<int64_t>(points[i].y) - static_cast<int64_t>(points[j].y)) + 1U);
-                maxArea = std::max(maxArea, area);
+                if (isRectangleValid(points[i], points[j], points))
+                {
+                    uint64_t area = static_cast<uint64_t>(std::abs(static_cast<int64_t>(points[i].x) - static_cast<int64_t>(points[j].x)) + 1U) *
+                                    static_cast<uint64_t>(std::abs(static_cast<int64_t>(points[i].y) - static_cast<int64_t>(points[j].y)) + 1U);
+                    maxArea = std::max(maxArea, area);
+                }
             }
-        }
+            return maxArea;
+        },
+        [](uint64_t a, uint64_t b)
+        { return std::max(a, b); },
+        1U);
+}
+
+// Binary cache columns: the x and y coordinates of the vertices, in order
+void storeParsed(aoc::ParsedInput &parsed, aoc::CacheWriter &cache)
+{
+    const auto &polygon = aoc::parsedData<Polygon>(parsed);
+    std::vector<uint32_t> xs, ys;
+    for (const auto &vertex : polygon)
+    {
+        xs.push_back(vertex.x);
+        ys.push_back(vertex.y);
     }
+    cache.addColumn<uint32_t>(xs);
+    cache.addColumn<uint32_t>(ys);
+}
+
+std::unique_ptr<aoc::ParsedInput> loadParsed(const aoc::CacheFile &cache)
+{
+    auto xs = cache.column<uint32_t>(0);
+    auto ys = cache.column<uint32_t>(1);
+    if (cache.columnCount() != 2U || ys.size() != xs.size())
+        return nullptr;
+
+    return aoc::makeLoaded(cache, [&](const aoc::CacheFile &, std::pmr::memory_resource *memory)
+                           {
+        Polygon polygon(memory);
+        polygon.reserve(xs.size());
+        for (size_t i = 0; i < xs.size(); ++i)
+            polygon.push_back({xs[i], ys[i]});
+        return polygon; });
+}
+
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int /* part */)
+{
+    return aoc::makeParsed(input, parseInput);
+}
 
-    return maxArea;
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part)
+{
+    const auto &inputData = aoc::parsedData<Polygon>(parsed);
+    if (part == 1)
+    {
+        auto areas = calculateArea(inputData);
+        return areas.empty() ? uint64_t{0} : *std::max_element(areas.begin(), areas.end());
+    }
+    return calculateMaxAreaWithGreenTiles(inputData);
 }
 
+} // namespace day09
+
+#ifndef AOC_RUNNER
 int main()
 {
+    using namespace day09;
+
     auto inputData = readInputFile("input/input.txt");
 
     // Part 1
@@ -168,3 +243,4 @@ int main()
 
     return 0;
 }
+#endif
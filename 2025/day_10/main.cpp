@@ -1,28 +1,46 @@
 #include <algorithm>
-#include <fstream>
+#include <climits>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <numeric>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
-#include <climits>
+
+#include "common/input_reader.hpp"
+#include "common/parse.hpp"
+#include "common/hash.hpp"
+#include "common/huge_pages.hpp"
+#include "common/pipeline.hpp"
+#include "common/result_cache.hpp"
+#include "common/solver.hpp"
+#include "common/stream.hpp"
+#include "common/thread_pool.hpp"
+
+namespace day10
+{
 
 struct Problem
 {
     uint32_t desiredState;
-    std::vector<uint32_t> switchMask;
-    std::vector<uint32_t> desiredJoltage;
+    std::pmr::vector<uint32_t> switchMask;
+    std::pmr::vector<uint32_t> desiredJoltage;
 };
 
-std::vector<Problem> readInputFile(const std::string &filePath)
+using ProblemList = std::pmr::vector<Problem>;
+
+ProblemList parseInput(std::string_view input, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
 {
-    std::vector<Problem> data;
-    std::ifstream file(filePath);
-    std::string line;
-    while (std::getline(file, line))
+    ProblemList data(memory);
+    for (std::string_view line : aoc::LineRange(input))
     {
         if (line.empty())
             continue;
-        Problem p;
+        Problem p{0U, std::pmr::vector<uint32_t>(memory), std::pmr::vector<uint32_t>(memory)};
         size_t closingBrace = line.find(']');
         p.desiredState = 0U;
         for (size_t i = 1; i < closingBrace; ++i)
@@ -35,15 +53,14 @@ std::vector<Problem> readInputFile(const std::string &filePath)
             {
                 size_t close = line.find(')', pos);
                 uint32_t mask = 0U;
-                size_t ipos = pos + 1;
-                while (ipos < close)
+                const char *cursor = line.data() + pos + 1;
+                const char *groupEnd = line.data() + close;
+                while (cursor < groupEnd)
                 {
-                    size_t comma = line.find(',', ipos);
-                    if (comma == std::string::npos || comma > close)
-                        comma = close;
-                    size_t idx = std::stoul(line.substr(ipos, comma - ipos));
+                    size_t idx = 0;
+                    cursor = aoc::parseUnsigned(cursor, groupEnd, idx);
                     mask |= (1U << idx);
-                    ipos = comma + 1;
+                    cursor++; // skip ','
                 }
                 p.switchMask.push_back(mask);
                 pos = close + 1;
@@ -51,29 +68,42 @@ std::vector<Problem> readInputFile(const std::string &filePath)
             else if (line[pos] == '{')
             {
                 size_t close = line.find('}', pos);
-                size_t ipos = pos + 1;
-                while (ipos < close)
+                const char *cursor = line.data() + pos + 1;
+                const char *groupEnd = line.data() + close;
+                while (cursor < groupEnd)
                 {
-                    size_t comma = line.find(',', ipos);
-                    if (comma == std::string::npos || comma > close)
-                        comma = close;
-                    p.desiredJoltage.push_back(std::stoul(line.substr(ipos, comma - ipos)));
-                    ipos = comma + 1;
+                    uint32_t joltage = 0U;
+                    cursor = aoc::parseUnsigned(cursor, groupEnd, joltage);
+                    p.desiredJoltage.push_back(joltage);
+                    cursor++; // skip ','
                 }
                 pos = close + 1;
             }
             else
                 pos++;
         }
-        data.push_back(p);
+        data.push_back(std::move(p));
     }
     return data;
 }
 
-size_t minTogglesBFS(uint32_t desiredState, const std::vector<uint32_t> &switchMasks)
+ProblemList readInputFile(const std::string &filePath)
+{
+    aoc::InputFile file(filePath);
+
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open file " << filePath << std::endl;
+        return {};
+    }
+
+    return parseInput(file.contents());
+}
+
+size_t minTogglesBFS(uint32_t desiredState, const std::pmr::vector<uint32_t> &switchMasks)
 {
     std::vector<std::pair<uint32_t, size_t>> q;
-    std::vector<bool> visited(1U << 20, false);
+    std::pmr::vector<bool> visited(1U << 20, false, aoc::largeTableResource());
     q.push_back({0U, 0});
     visited[0] = true;
     size_t head = 0;
@@ -185,33 +215,151 @@ size_t minButtonPressesJoltage(const Problem &problem)
     return SIZE_MAX;
 }
 
-void part1(const std::vector<Problem> &inputData)
+// Per-machine answers in the result cache are keyed by this version and the
+// machine's own contents; bump it when either search changes
+constexpr int DAY = 10;
+constexpr int MACHINE_RESULT_VERSION = 1;
+
+uint64_t hashMachine(const Problem &problem)
 {
-    size_t total = 0U;
-    for (size_t i = 0; i < inputData.size(); ++i)
+    auto bytes = [](const auto *data, size_t count)
+    { return std::string_view(reinterpret_cast<const char *>(data), count * sizeof(*data)); };
+
+    uint64_t hash = aoc::xxh64(bytes(&problem.desiredState, 1U));
+    hash = aoc::xxh64(bytes(problem.switchMask.data(), problem.switchMask.size()), hash);
+    return aoc::xxh64(bytes(problem.desiredJoltage.data(), problem.desiredJoltage.size()), hash);
+}
+
+// Runs search(problem), or reads its answer back when the result cache has
+// already seen this machine, so an edited input only re-solves changed lines
+template <typename Search>
+size_t solveMachine(const Problem &problem, int part, Search &&search)
+{
+    aoc::ResultCache &results = aoc::ResultCache::instance();
+    if (!results.enabled())
+        return search(problem);
+
+    aoc::ResultKey key{DAY, part, MACHINE_RESULT_VERSION, hashMachine(problem)};
+    if (auto known = results.find(key))
+        return static_cast<size_t>(*known);
+
+    size_t answer = search(problem);
+    results.store(key, static_cast<int64_t>(answer));
+    return answer;
+}
+
+// Machines differ wildly in search cost, so each is its own pool task
+size_t part1(const ProblemList &inputData)
+{
+    return aoc::parallelReduce(
+        0U, inputData.size(), size_t{0},
+        [&](size_t i)
+        {
+            return solveMachine(inputData[i], 1, [](const Problem &problem)
+                                { return minTogglesBFS(problem.desiredState, problem.switchMask); });
+        },
+        std::plus<size_t>(), 1U);
+}
+
+size_t part2(const ProblemList &inputData)
+{
+    return aoc::parallelReduce(
+        0U, inputData.size(), size_t{0},
+        [&](size_t i)
+        {
+            auto presses = solveMachine(inputData[i], 2, minButtonPressesJoltage);
+            return presses != SIZE_MAX ? presses : size_t{0};
+        },
+        std::plus<size_t>(), 1U);
+}
+
+// Machines are independent, so a chunk of whole lines is parsed and solved on
+// its own and only the totals are kept
+size_t solveChunk(std::string_view chunk, int part)
+{
+    aoc::Arena arena(chunk);
+    auto machines = parseInput(chunk, arena.resource());
+    return part == 1 ? part1(machines) : part2(machines);
+}
+
+size_t processInputFile(const std::string &filePath, int part)
+{
+    aoc::InputFile file(filePath);
+
+    if (!file.isOpen())
     {
-        auto toggles = minTogglesBFS(inputData[i].desiredState, inputData[i].switchMask);
-        total += toggles;
+        std::cerr << "Error: Could not open file " << filePath << std::endl;
+        return 0;
     }
-    std::cout << "Part 1: Total minimum toggles: " << total << std::endl;
+
+    size_t total = 0U;
+    aoc::ChunkSource source(file.contents());
+    aoc::runPipeline(
+        source, [part](std::string_view chunk)
+        { return solveChunk(chunk, part); },
+        [&](size_t chunkTotal)
+        { total += chunkTotal; });
+    return total;
 }
 
-void part2(const std::vector<Problem> &inputData)
+// Machines piped to stdin, solved chunk by chunk as they arrive. --part 1
+// skips the far more expensive part 2 search.
+int streamInput(const aoc::StreamOptions &options)
 {
-    size_t total = 0U;
-    for (size_t i = 0; i < inputData.size(); ++i)
+    size_t part1Total = 0U, part2Total = 0U;
+    auto printTotals = [&](const std::string &label)
     {
-        auto presses = minButtonPressesJoltage(inputData[i]);
-        if (presses != SIZE_MAX)
-            total += presses;
-    }
-    std::cout << "Part 2: Total minimum button presses: " << total << std::endl;
+        std::cout << label << ":";
+        if (aoc::streamsPart(options, 1))
+            std::cout << " part 1 " << part1Total;
+        if (aoc::streamsPart(options, 2))
+            std::cout << " part 2 " << part2Total;
+        std::cout << std::endl;
+    };
+
+    aoc::ChunkSource source(STDIN_FILENO, options.chunkBytes);
+    aoc::runStreaming(
+        source, options, [&](std::string_view chunk)
+        {
+            aoc::Arena arena(chunk);
+            auto machines = parseInput(chunk, arena.resource());
+            size_t toggles = aoc::streamsPart(options, 1) ? part1(machines) : 0U;
+            size_t presses = aoc::streamsPart(options, 2) ? part2(machines) : 0U;
+            return std::make_pair(toggles, presses); },
+        [&](std::pair<size_t, size_t> chunkTotals)
+        {
+            part1Total += chunkTotals.first;
+            part2Total += chunkTotals.second; },
+        [&](size_t bytes)
+        { printTotals("After " + std::to_string(bytes) + " bytes"); });
+    printTotals("Total");
+    return 0;
+}
+
+std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int /* part */)
+{
+    return aoc::makeParsed(input, parseInput);
 }
 
-int main()
+aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part)
 {
-    auto inputData = readInputFile("input/input.txt");
-    part1(inputData);
-    part2(inputData);
+    const auto &inputData = aoc::parsedData<ProblemList>(parsed);
+    return part == 1 ? part1(inputData) : part2(inputData);
+}
+
+} // namespace day10
+
+#ifndef AOC_RUNNER
+int main(int argc, char **argv)
+{
+    using namespace day10;
+
+    auto streamOptions = aoc::parseStreamOptions(argc, argv);
+    if (streamOptions.enabled)
+        return streamOptions.valid ? streamInput(streamOptions) : 1;
+
+    std::cout << "Part 1: Total minimum toggles: " << processInputFile("input/input.txt", 1) << std::endl;
+    std::cout << "Part 2: Total minimum button presses: " << processInputFile("input/input.txt", 2) << std::endl;
     return 0;
 }
+#endif
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Timing baselines for the aoc runner. A baseline is a plain text file holding
+// the raw per-repeat samples of every (day, part, input size, phase) that was
+// measured, so a later run can be compared with a rank test instead of a
+// single number:
+//
+//   aoc-baseline 1
+//   # day part input_bytes phase samples_ms...
+//   8 1 18654 parse 0.412 0.398 0.405
+//   8 1 18654 solve 61.2 60.8 61.9
+//
+// The first line carries the format version; files with another version are
+// rejected rather than misread.
+
+namespace aoc
+{
+
+constexpr int BASELINE_VERSION = 1;
+
+struct BaselineEntry
+{
+    int day = 0;
+    int part = 0;
+    size_t inputBytes = 0;
+    std::string phase;
+    std::vector<double> samples; // milliseconds
+
+    bool sameKey(const BaselineEntry &other) const
+    {
+        return day == other.day && part == other.part && inputBytes == other.inputBytes && phase == other.phase;
+    }
+};
+
+inline bool loadBaseline(const std::string &path, std::vector<BaselineEntry> &entries)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not open file " << path << std::endl;
+        return false;
+    }
+
+    std::string magic;
+    int version = 0;
+    if (!(file >> magic >> version) || magic != "aoc-baseline")
+    {
+        std::cerr << "Error: " << path << " is not an aoc baseline" << std::endl;
+        return false;
+    }
+    if (version != BASELINE_VERSION)
+    {
+        std::cerr << "Error: " << path << " has baseline version " << version << ", expected " << BASELINE_VERSION << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream fields(line);
+        BaselineEntry entry;
+        if (!(fields >> entry.day >> entry.part >> entry.inputBytes >> entry.phase))
+        {
+            std::cerr << "Error: malformed baseline line: " << line << std::endl;
+            return false;
+        }
+        for (double sample; fields >> sample;)
+            entry.samples.push_back(sample);
+        entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+inline bool saveBaseline(const std::string &path, std::vector<BaselineEntry> entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const BaselineEntry &a, const BaselineEntry &b)
+              { return std::tie(a.day, a.part, a.inputBytes, a.phase) < std::tie(b.day, b.part, b.inputBytes, b.phase); });
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not open file " << path << std::endl;
+        return false;
+    }
+
+    file << "aoc-baseline " << BASELINE_VERSION << "\n# day part input_bytes phase samples_ms...\n";
+    file << std::setprecision(6);
+    for (const auto &entry : entries)
+    {
+        file << entry.day << ' ' << entry.part << ' ' << entry.inputBytes << ' ' << entry.phase;
+        for (double sample : entry.samples)
+            file << ' ' << sample;
+        file << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+// Replaces entries with the same key and appends new ones, so saving a run of
+// a single day keeps the rest of an existing baseline.
+inline void mergeBaseline(std::vector<BaselineEntry> &into, const std::vector<BaselineEntry> &from)
+{
+    for (const auto &entry : from)
+    {
+        auto existing = std::find_if(into.begin(), into.end(), [&](const BaselineEntry &other)
+                                     { return other.sameKey(entry); });
+        if (existing != into.end())
+            *existing = entry;
+        else
+            into.push_back(entry);
+    }
+}
+
+} // namespace aoc
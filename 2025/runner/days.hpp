@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+
+#include "common/solver.hpp"
+
+// Entry points of the day libraries linked into the aoc runner. Each day's
+// main.cpp is compiled with AOC_RUNNER defined, which drops its standalone
+// main() and leaves dayNN::parse and dayNN::solveParsed.
+
+#define AOC_DECLARE_DAY(ns)                                                      \
+    namespace ns                                                                 \
+    {                                                                            \
+    std::unique_ptr<aoc::ParsedInput> parse(std::string_view input, int part); \
+    aoc::Answer solveParsed(aoc::ParsedInput &parsed, int part);               \
+    }
+
+// Days with a binary input cache also provide storeParsed and loadParsed
+#define AOC_DECLARE_CACHED_DAY(ns)                                                \
+    AOC_DECLARE_DAY(ns)                                                           \
+    namespace ns                                                                  \
+    {                                                                             \
+    void storeParsed(aoc::ParsedInput &parsed, aoc::CacheWriter &cache);          \
+    std::unique_ptr<aoc::ParsedInput> loadParsed(const aoc::CacheFile &cache);   \
+    }
+
+AOC_DECLARE_DAY(day01)
+AOC_DECLARE_DAY(day02)
+AOC_DECLARE_DAY(day03)
+AOC_DECLARE_CACHED_DAY(day04)
+AOC_DECLARE_CACHED_DAY(day05)
+AOC_DECLARE_DAY(day06)
+AOC_DECLARE_DAY(day07)
+AOC_DECLARE_CACHED_DAY(day08)
+AOC_DECLARE_CACHED_DAY(day09)
+AOC_DECLARE_DAY(day10)
+
+#undef AOC_DECLARE_CACHED_DAY
+#undef AOC_DECLARE_DAY
+
+namespace aoc
+{
+
+inline constexpr DayEntry DAYS[] = {
+    {1, day01::parse, day01::solveParsed, InputUnit::LINES, 1},
+    {2, day02::parse, day02::solveParsed, InputUnit::FIELDS, 1},
+    {3, day03::parse, day03::solveParsed, InputUnit::LINES, 1},
+    {4, day04::parse, day04::solveParsed, InputUnit::CELLS, 1, day04::storeParsed, day04::loadParsed},
+    {5, day05::parse, day05::solveParsed, InputUnit::LINES, 1, day05::storeParsed, day05::loadParsed},
+    {6, day06::parse, day06::solveParsed, InputUnit::CELLS, 1},
+    {7, day07::parse, day07::solveParsed, InputUnit::CELLS, 1},
+    {8, day08::parse, day08::solveParsed, InputUnit::LINES, 1, day08::storeParsed, day08::loadParsed},
+    {9, day09::parse, day09::solveParsed, InputUnit::LINES, 1, day09::storeParsed, day09::loadParsed},
+    {10, day10::parse, day10::solveParsed, InputUnit::LINES, 1},
+};
+
+inline const DayEntry *findDay(int day)
+{
+    for (const auto &entry : DAYS)
+    {
+        if (entry.day == day)
+            return &entry;
+    }
+    return nullptr;
+}
+
+} // namespace aoc
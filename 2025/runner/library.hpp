@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "common/solver.hpp"
+#include "common/thread_pool.hpp"
+#include "runner/days.hpp"
+
+// In-process API over the day library: link build/libdays.a, include this
+// header and solve a puzzle held in memory without files or a main().
+//
+//   auto results = aoc::solveDay(5, buffer);
+//   if (results)
+//       use(results->part1, results->part2);
+//
+// Both parts run as tasks on the shared pool, each with its own parse, so a
+// part that modifies its parsed input cannot affect the other. The result
+// cache is consulted when it is enabled (see common/result_cache.hpp).
+
+namespace aoc
+{
+
+struct DayResults
+{
+    Answer part1 = 0;
+    Answer part2 = 0;
+    uint64_t nanoseconds = 0U; // parse and solve time summed over both parts
+};
+
+// Answers of both parts of `day` for `input`; empty if there is no such day
+inline std::optional<DayResults> solveDay(int day, std::string_view input, ThreadPool &pool = ThreadPool::instance())
+{
+    const DayEntry *entry = findDay(day);
+    if (entry == nullptr)
+        return std::nullopt;
+
+    PhaseRecorder phases[2];
+    DayResults results;
+    TaskGroup group(pool);
+    group.run([&]
+              { results.part1 = entry->solve(input, 1, phases[0]); });
+    group.run([&]
+              { results.part2 = entry->solve(input, 2, phases[1]); });
+    group.wait();
+
+    results.nanoseconds = phases[0].totalNanoseconds() + phases[1].totalNanoseconds();
+    return results;
+}
+
+} // namespace aoc
@@ -0,0 +1,841 @@
+// aoc: single driver for every day of the 2025 puzzles.
+//
+//   ./aoc [--day N|all] [--part 1|2|both] [--input PATH] [--repeat R] [--json PATH|-]
+//         [--threads N] [--isa LEVEL] [--huge-pages MODE] [--concurrent] [--cache] [--results PATH] [--trace PATH] [--counters] [--allocations] [--save-baseline PATH] [--baseline PATH [--threshold PCT] [--alpha P]]
+//
+// Each (day, part) is run R times; parse, solve and total wall times are
+// reported as min/median/p99 in milliseconds. --json also writes them as JSON
+// to PATH, or to stdout for -, in which case the text report goes to stderr
+// so stdout stays parseable. Without --input, day N reads
+// day_NN/input/input.txt relative to the working directory. --trace sends the
+// solvers' diagnostics to PATH (only those compiled in with TRACE_LEVEL=N).
+// --threads sizes the pool the solvers share (default: AOC_THREADS, else one
+// per hardware thread). --isa caps the instruction set the dispatched kernels
+// use (baseline, sse4.2, avx2 or avx512; default: AOC_ISA, else the best the
+// CPU has, see common/cpu_dispatch.hpp) so the variants can be compared on one
+// machine; the level in use is shown in the report. --concurrent schedules
+// every selected day and part on that pool at once, each as a parse task
+// followed by its solve task, and adds the wall time of the whole round to the
+// report; results are still listed in day order.
+//
+// --huge-pages backs the large tables (parse arenas, day 08's pair distances,
+// day 10's visited set) with 2 MiB pages: thp advises transparent huge pages,
+// hugetlb maps from the hugetlbfs pool first, off (the default, or
+// AOC_HUGE_PAGES) leaves them on the heap; see common/huge_pages.hpp. The
+// report says how the large blocks were backed. With --counters, compare the
+// dtlb/el column of runs with and without to see the TLB misses saved.
+//
+// --cache loads days 04, 05, 08 and 09 from a pre-parsed binary form of their
+// input (see common/binary_cache.hpp) stored next to the input as
+// PATH.<xxh64>.cache. A missing or stale cache is written first, outside the
+// timed runs, so the parse phase then measures mapping and loading the cache.
+// Other days parse their text as usual. --results PATH keeps answers in an
+// on-disk result cache (see common/result_cache.hpp): a part whose day, solver
+// version and input hash are already there is answered from it, and its
+// solve time is the lookup.
+//
+// --counters reads hardware counters (perf_event_open) around each phase and
+// adds IPC and per-element cycles and misses to the report. Counters the
+// kernel or CPU does not provide are shown as n/a. --allocations counts heap
+// allocations, bytes and peak live bytes per phase through the replaced
+// global operator new (see common/alloc_tracker.hpp).
+//
+// --save-baseline stores the raw samples of this run in PATH (merged with what
+// is already there). --baseline compares this run against PATH: a phase has
+// regressed when its median grew by more than --threshold percent (default 10)
+// and a one-sided Mann-Whitney test on the samples rejects "no slowdown" at
+// --alpha (default 0.05). Regressions are listed and the exit status is 3.
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/alloc_hooks.hpp"
+#include "common/cpu_dispatch.hpp"
+#include "common/huge_pages.hpp"
+#include "common/input_reader.hpp"
+#include "common/solver.hpp"
+#include "common/stats.hpp"
+#include "common/thread_pool.hpp"
+#include "common/trace.hpp"
+#include "runner/baseline.hpp"
+#include "runner/days.hpp"
+
+namespace
+{
+
+struct Options
+{
+    std::vector<int> days;
+    std::vector<int> parts = {1, 2};
+    std::string inputPath;
+    int repeat = 1;
+    size_t threads = 0U;
+    std::optional<aoc::cpu::IsaLevel> isa;
+    std::optional<aoc::HugePageMode> hugePages;
+    bool concurrent = false;
+    bool cache = false;
+    std::string resultsPath;
+    std::string jsonPath;
+    std::string tracePath;
+    bool counters = false;
+    bool allocations = false;
+    std::string saveBaselinePath;
+    std::string baselinePath;
+    double thresholdPercent = 10.0;
+    double alpha = 0.05;
+};
+
+// Exit status when --baseline finds a regression
+constexpr int EXIT_REGRESSION = 3;
+
+// Below this many samples per side the rank test cannot reach a useful
+// significance level, so the threshold alone decides
+constexpr size_t MIN_TEST_SAMPLES = 5;
+
+// Median changes smaller than this are timer noise whatever their percentage
+constexpr double NOISE_FLOOR_MS = 0.02;
+
+struct PartReport
+{
+    int day;
+    int part;
+    std::string inputPath;
+    size_t inputBytes;
+    aoc::Answer answer;
+    bool consistent;
+    aoc::Summary parseMs;
+    aoc::Summary solveMs;
+    aoc::Summary totalMs;
+    std::vector<double> parseSamples;
+    std::vector<double> solveSamples;
+    std::vector<double> totalSamples;
+    size_t elements;
+    std::array<aoc::CounterValues, aoc::PHASE_COUNT> counters;       // mean per repeat
+    std::array<aoc::AllocationStats, aoc::PHASE_COUNT> allocations; // mean per repeat, peak is the max
+};
+
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--day N|all] [--part 1|2|both] [--input PATH] [--repeat R] [--threads N] [--isa LEVEL] [--huge-pages MODE] [--concurrent] [--cache] [--results PATH] [--json PATH|-] [--trace PATH] [--counters] [--allocations]\n"
+              << "       [--save-baseline PATH] [--baseline PATH [--threshold PCT] [--alpha P]]" << std::endl;
+}
+
+// Whole decimal number with nothing after it
+template <typename T>
+bool parseNumber(const std::string &text, T &result)
+{
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), result);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: " << arg << " needs a value" << std::endl;
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        auto positive = [&](auto &result) -> bool
+        {
+            std::string text = value();
+            if (!parseNumber(text, result) || result < 1)
+            {
+                std::cerr << "Error: " << arg << " expects a positive integer, got " << text << std::endl;
+                return false;
+            }
+            return true;
+        };
+
+        if (arg == "--day")
+        {
+            std::string day = value();
+            int number = 0;
+            if (day != "all" && !parseNumber(day, number))
+            {
+                std::cerr << "Error: --day must be a day number or all, got " << day << std::endl;
+                return false;
+            }
+            if (day != "all")
+                options.days.push_back(number);
+        }
+        else if (arg == "--part")
+        {
+            std::string part = value();
+            int number = 0;
+            if (part == "both")
+                options.parts = {1, 2};
+            else if (parseNumber(part, number))
+                options.parts = {number};
+            else
+            {
+                std::cerr << "Error: --part must be 1, 2 or both" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--input")
+            options.inputPath = value();
+        else if (arg == "--repeat")
+        {
+            if (!positive(options.repeat))
+                return false;
+        }
+        else if (arg == "--threads")
+        {
+            if (!positive(options.threads))
+                return false;
+        }
+        else if (arg == "--isa")
+        {
+            std::string name = value();
+            aoc::cpu::IsaLevel level;
+            if (!aoc::cpu::parseIsaLevel(name, level))
+            {
+                std::cerr << "Error: unknown ISA level " << name << " (baseline, sse4.2, avx2 or avx512)" << std::endl;
+                return false;
+            }
+            options.isa = level;
+        }
+        else if (arg == "--huge-pages")
+        {
+            std::string name = value();
+            aoc::HugePageMode mode;
+            if (!aoc::parseHugePageMode(name, mode))
+            {
+                std::cerr << "Error: unknown huge page mode " << name << " (off, thp or hugetlb)" << std::endl;
+                return false;
+            }
+            options.hugePages = mode;
+        }
+        else if (arg == "--concurrent")
+            options.concurrent = true;
+        else if (arg == "--cache")
+            options.cache = true;
+        else if (arg == "--results")
+            options.resultsPath = value();
+        else if (arg == "--json")
+            options.jsonPath = value();
+        else if (arg == "--trace")
+            options.tracePath = value();
+        else if (arg == "--counters")
+            options.counters = true;
+        else if (arg == "--allocations")
+            options.allocations = true;
+        else if (arg == "--save-baseline")
+            options.saveBaselinePath = value();
+        else if (arg == "--baseline")
+            options.baselinePath = value();
+        else if (arg == "--threshold")
+            options.thresholdPercent = std::atof(value().c_str());
+        else if (arg == "--alpha")
+            options.alpha = std::atof(value().c_str());
+        else if (arg == "--help" || arg == "-h")
+        {
+            printUsage(argv[0]);
+            std::exit(0);
+        }
+        else
+        {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.days.empty())
+    {
+        for (const auto &entry : aoc::DAYS)
+            options.days.push_back(entry.day);
+    }
+
+    if (!options.inputPath.empty() && options.days.size() != 1)
+    {
+        std::cerr << "Error: --input needs a single --day" << std::endl;
+        return false;
+    }
+
+    if (options.concurrent && (options.counters || options.allocations))
+    {
+        std::cerr << "Error: --counters and --allocations measure one solver at a time and cannot be used with --concurrent" << std::endl;
+        return false;
+    }
+
+    for (int part : options.parts)
+    {
+        if (part != 1 && part != 2)
+        {
+            std::cerr << "Error: --part must be 1, 2 or both" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string defaultInputPath(int day)
+{
+    char path[64];
+    std::snprintf(path, sizeof(path), "day_%02d/input/input.txt", day);
+    return path;
+}
+
+PartReport startReport(const aoc::DayEntry &entry, int part, const std::string &inputPath, std::string_view input)
+{
+    return PartReport{entry.day, part, inputPath, input.size(), 0, true, {}, {}, {}, {}, {}, {},
+                      aoc::countElements(input, entry.unit), {}, {}};
+}
+
+// Adds one run of a part to its report
+void addRun(PartReport &report, const aoc::PhaseRecorder &phases, aoc::Answer answer)
+{
+    if (report.totalSamples.empty())
+        report.answer = answer;
+    else if (answer != report.answer)
+        report.consistent = false;
+
+    report.parseSamples.push_back(phases.nanoseconds(aoc::Phase::PARSE) / 1e6);
+    report.solveSamples.push_back(phases.nanoseconds(aoc::Phase::SOLVE) / 1e6);
+    report.totalSamples.push_back(phases.totalNanoseconds() / 1e6);
+    for (size_t phase = 0; phase < aoc::PHASE_COUNT; ++phase)
+    {
+        report.counters[phase] += phases.counters(static_cast<aoc::Phase>(phase));
+        report.allocations[phase] += phases.allocations(static_cast<aoc::Phase>(phase));
+    }
+}
+
+// Turns the accumulated runs into summaries and per-run means
+void finishReport(PartReport &report)
+{
+    size_t runs = std::max<size_t>(report.totalSamples.size(), 1U);
+    for (auto &values : report.counters)
+    {
+        for (auto &value : values.values)
+            value /= runs;
+    }
+    for (auto &stats : report.allocations)
+    {
+        stats.allocations /= runs;
+        stats.bytes /= runs;
+    }
+
+    report.parseMs = aoc::summarize(report.parseSamples);
+    report.solveMs = aoc::summarize(report.solveSamples);
+    report.totalMs = aoc::summarize(report.totalSamples);
+}
+
+PartReport runPart(const aoc::DayEntry &entry, int part, const std::string &inputPath, std::string_view input, int repeat,
+                   const aoc::PerfCounters *counters, const aoc::CacheLocation *cache)
+{
+    PartReport report = startReport(entry, part, inputPath, input);
+    for (int r = 0; r < repeat; ++r)
+    {
+        aoc::PhaseRecorder phases;
+        phases.attach(counters);
+        aoc::Answer answer = entry.solve(input, part, phases, cache);
+        addRun(report, phases, answer);
+    }
+    finishReport(report);
+    return report;
+}
+
+// Finds the binary cache for an input, writing it when there is none for
+// these input bytes yet. Returns null when it cannot be written.
+std::unique_ptr<aoc::CacheLocation> prepareCache(const aoc::DayEntry &entry, const std::string &inputPath, std::string_view input)
+{
+    auto cache = std::make_unique<aoc::CacheLocation>(aoc::locateCache(inputPath, input));
+    if (aoc::CacheFile(cache->path, entry.day, cache->inputHash).isOpen())
+        return cache;
+
+    if (!entry.writeCache(input, *cache))
+    {
+        std::cerr << "Warning: could not write cache " << cache->path << ", parsing day " << entry.day << " from text" << std::endl;
+        return nullptr;
+    }
+    std::cerr << "Wrote cache " << cache->path << std::endl;
+    return cache;
+}
+
+// One (day, part) of a concurrent round
+struct ConcurrentJob
+{
+    const aoc::DayEntry *entry;
+    int part;
+    std::string_view input;
+    const aoc::CacheLocation *cache;
+    std::unique_ptr<aoc::ParsedInput> parsed;
+    aoc::PhaseRecorder phases;
+    aoc::Answer answer = 0;
+};
+
+// Runs every job once on the shared pool. Each job is a parse task that
+// spawns its solve task when done; jobs are submitted longest-first by their
+// last measured time so the slowest chain starts as early as possible.
+// Returns the wall time of the round in milliseconds.
+double runConcurrentRound(std::vector<ConcurrentJob> &jobs, const std::vector<size_t> &order)
+{
+    auto start = std::chrono::steady_clock::now();
+    aoc::TaskGroup group;
+    for (size_t index : order)
+    {
+        ConcurrentJob &job = jobs[index];
+        job.phases.reset();
+        group.run([&group, &job]
+                  {
+            aoc::ResultCache &results = aoc::ResultCache::instance();
+            std::optional<aoc::ResultKey> key;
+            if (results.enabled())
+            {
+                auto known = job.phases.measure(aoc::Phase::SOLVE, [&]
+                                                {
+                    key = job.entry->resultKey(job.input, job.part);
+                    return results.find(*key); });
+                if (known)
+                {
+                    job.answer = *known;
+                    return;
+                }
+            }
+
+            job.parsed = job.phases.measure(aoc::Phase::PARSE, [&]
+                                            { return job.entry->prepare(job.input, job.part, job.cache); });
+            group.run([&job, key]
+                      {
+                job.answer = job.phases.measure(aoc::Phase::SOLVE, [&]
+                                                { return job.entry->solveParsed(*job.parsed, job.part); });
+                job.parsed.reset();
+                if (key)
+                    aoc::ResultCache::instance().store(*key, job.answer); }); });
+    }
+    group.wait();
+    aoc::ResultCache::instance().flush();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs all jobs concurrently `repeat` times and fills one report per job, in
+// job order. Returns the wall time of every round.
+std::vector<double> runConcurrent(std::vector<ConcurrentJob> &jobs, std::vector<PartReport> &reports, int repeat)
+{
+    std::vector<size_t> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0U);
+
+    std::vector<double> wallMs;
+    for (int r = 0; r < repeat; ++r)
+    {
+        wallMs.push_back(runConcurrentRound(jobs, order));
+        for (size_t i = 0; i < jobs.size(); ++i)
+            addRun(reports[i], jobs[i].phases, jobs[i].answer);
+
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                         { return jobs[a].phases.totalNanoseconds() > jobs[b].phases.totalNanoseconds(); });
+    }
+
+    for (auto &report : reports)
+        finishReport(report);
+    return wallMs;
+}
+
+void printText(std::ostream &out, const std::vector<PartReport> &reports, int repeat)
+{
+    auto timing = [](const aoc::Summary &summary)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(3) << summary.min << "/" << summary.median << "/" << summary.p99;
+        return text.str();
+    };
+
+    out << "repeats: " << repeat << ", isa: " << aoc::cpu::isaName(aoc::cpu::activeIsa()) << ", huge pages: "
+        << aoc::hugePageModeName(aoc::hugepages::resource().mode()) << ", times in ms as min/median/p99" << std::endl;
+    out << std::left << std::setw(5) << "day" << std::setw(6) << "part" << std::right << std::setw(20) << "answer"
+        << std::setw(28) << "parse" << std::setw(28) << "solve" << std::setw(28) << "total" << std::endl;
+    for (const auto &report : reports)
+    {
+        out << std::left << std::setw(5) << report.day << std::setw(6) << report.part << std::right
+            << std::setw(20) << report.answer << std::setw(28) << timing(report.parseMs)
+            << std::setw(28) << timing(report.solveMs) << std::setw(28) << timing(report.totalMs);
+        if (!report.consistent)
+            out << "  (answer changed between repeats)";
+        out << std::endl;
+    }
+}
+
+void printConcurrent(std::ostream &out, const std::vector<PartReport> &reports, const std::vector<double> &wallMs)
+{
+    double sumMs = 0.0, slowestMs = 0.0;
+    for (const auto &report : reports)
+    {
+        sumMs += report.totalMs.median;
+        slowestMs = std::max(slowestMs, report.totalMs.median);
+    }
+
+    auto wall = aoc::summarize(wallMs);
+    out << std::fixed << std::setprecision(3) << "\nconcurrent, pool size " << aoc::ThreadPool::instance().size()
+        << ": wall " << wall.min << "/" << wall.median << "/" << wall.p99
+        << " ms; sum of part totals " << sumMs << " ms, slowest part " << slowestMs << " ms" << std::endl;
+}
+
+void printHugePages(std::ostream &out)
+{
+    aoc::HugePageStats stats = aoc::hugepages::resource().stats();
+    out << std::fixed << std::setprecision(1) << "\nhuge pages (" << aoc::hugePageModeName(aoc::hugepages::resource().mode())
+        << "): " << stats.hugetlbBlocks << " hugetlb and " << stats.transparentBlocks << " thp blocks, "
+        << stats.mappedBytes / 1048576.0 << " MiB mapped; " << stats.heapBlocks << " blocks fell back to the heap"
+        << std::endl;
+}
+
+void printCounters(std::ostream &out, const std::vector<PartReport> &reports)
+{
+    constexpr aoc::Counter PER_ELEMENT[] = {aoc::Counter::CYCLES, aoc::Counter::CACHE_MISSES, aoc::Counter::BRANCH_MISSES,
+                                            aoc::Counter::DTLB_MISSES};
+
+    out << "\nhardware counters, mean per run; misses and cycles per input element" << std::endl;
+    out << std::left << std::setw(5) << "day" << std::setw(6) << "part" << std::setw(7) << "phase" << std::right
+        << std::setw(10) << "elements" << std::setw(8) << "IPC" << std::setw(14) << "cycles/el"
+        << std::setw(14) << "cache/el" << std::setw(14) << "branch/el" << std::setw(14) << "dtlb/el" << std::endl;
+    for (const auto &report : reports)
+    {
+        for (size_t phase = 0; phase < aoc::PHASE_COUNT; ++phase)
+        {
+            const auto &values = report.counters[phase];
+            out << std::left << std::setw(5) << report.day << std::setw(6) << report.part << std::setw(7)
+                << aoc::phaseName(static_cast<aoc::Phase>(phase)) << std::right << std::setw(10) << report.elements
+                << std::fixed << std::setprecision(2);
+            if (values.ipc() > 0.0)
+                out << std::setw(8) << values.ipc();
+            else
+                out << std::setw(8) << "n/a";
+            for (auto counter : PER_ELEMENT)
+            {
+                if (values.has(counter) && report.elements > 0U)
+                    out << std::setw(14) << static_cast<double>(values[counter]) / report.elements;
+                else
+                    out << std::setw(14) << "n/a";
+            }
+            out << std::endl;
+        }
+    }
+}
+
+void printAllocations(std::ostream &out, const std::vector<PartReport> &reports)
+{
+    auto kib = [](uint64_t bytes)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << bytes / 1024.0;
+        return text.str();
+    };
+
+    out << "\nheap per run (bytes in KiB; peak is live bytes above the level at phase start)" << std::endl;
+    out << std::left << std::setw(5) << "day" << std::setw(6) << "part" << std::setw(7) << "phase" << std::right
+        << std::setw(14) << "allocations" << std::setw(16) << "allocated" << std::setw(16) << "peak" << std::endl;
+    for (const auto &report : reports)
+    {
+        for (size_t phase = 0; phase < aoc::PHASE_COUNT; ++phase)
+        {
+            const auto &stats = report.allocations[phase];
+            out << std::left << std::setw(5) << report.day << std::setw(6) << report.part << std::setw(7)
+                << aoc::phaseName(static_cast<aoc::Phase>(phase)) << std::right << std::setw(14) << stats.allocations
+                << std::setw(16) << kib(stats.bytes) << std::setw(16) << kib(stats.peakBytes) << std::endl;
+        }
+    }
+}
+
+void writeJson(std::ostream &out, const std::vector<PartReport> &reports, int repeat, bool counters, bool allocations)
+{
+    auto summary = [&](const char *name, const aoc::Summary &s)
+    {
+        out << "\"" << name << "\": {\"min\": " << s.min << ", \"median\": " << s.median
+            << ", \"p99\": " << s.p99 << ", \"mean\": " << s.mean << "}";
+    };
+
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n  \"repeat\": " << repeat << ",\n  \"isa\": \"" << aoc::cpu::isaName(aoc::cpu::activeIsa())
+        << "\",\n  \"huge_pages\": \"" << aoc::hugePageModeName(aoc::hugepages::resource().mode())
+        << "\",\n  \"unit\": \"ms\",\n  \"results\": [";
+    for (size_t i = 0; i < reports.size(); ++i)
+    {
+        const auto &report = reports[i];
+        out << (i ? ",\n" : "\n") << "    {\"day\": " << report.day << ", \"part\": " << report.part
+            << ", \"input\": \"" << report.inputPath << "\", \"input_bytes\": " << report.inputBytes
+            << ", \"answer\": " << report.answer << ", \"consistent\": " << (report.consistent ? "true" : "false") << ", ";
+        summary("parse", report.parseMs);
+        out << ", ";
+        summary("solve", report.solveMs);
+        out << ", ";
+        summary("total", report.totalMs);
+        if (counters)
+        {
+            out << ", \"elements\": " << report.elements << ", \"counters\": {";
+            for (size_t phase = 0; phase < aoc::PHASE_COUNT; ++phase)
+            {
+                const auto &values = report.counters[phase];
+                out << (phase ? ", " : "") << "\"" << aoc::phaseName(static_cast<aoc::Phase>(phase)) << "\": {";
+                bool first = true;
+                for (size_t c = 0; c < aoc::COUNTER_COUNT; ++c)
+                {
+                    auto counter = static_cast<aoc::Counter>(c);
+                    if (!values.has(counter))
+                        continue;
+                    out << (first ? "" : ", ") << "\"" << aoc::counterName(counter) << "\": " << values[counter];
+                    first = false;
+                }
+                out << "}";
+            }
+            out << "}";
+        }
+        if (allocations)
+        {
+            out << ", \"allocations\": {";
+            for (size_t phase = 0; phase < aoc::PHASE_COUNT; ++phase)
+            {
+                const auto &stats = report.allocations[phase];
+                out << (phase ? ", " : "") << "\"" << aoc::phaseName(static_cast<aoc::Phase>(phase))
+                    << "\": {\"count\": " << stats.allocations << ", \"bytes\": " << stats.bytes
+                    << ", \"peak_bytes\": " << stats.peakBytes << "}";
+            }
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}" << std::endl;
+}
+
+std::vector<aoc::BaselineEntry> toBaseline(const std::vector<PartReport> &reports)
+{
+    std::vector<aoc::BaselineEntry> entries;
+    for (const auto &report : reports)
+    {
+        entries.push_back({report.day, report.part, report.inputBytes, "parse", report.parseSamples});
+        entries.push_back({report.day, report.part, report.inputBytes, "solve", report.solveSamples});
+        entries.push_back({report.day, report.part, report.inputBytes, "total", report.totalSamples});
+    }
+    return entries;
+}
+
+struct Regression
+{
+    const aoc::BaselineEntry *before;
+    const aoc::BaselineEntry *after;
+    double beforeMedian;
+    double afterMedian;
+    double changePercent;
+    double pValue;
+};
+
+// Compares every measured phase with the baseline entry of the same key and
+// prints the ones that got slower. Returns the number of regressions.
+size_t compareWithBaseline(std::ostream &out, const std::vector<aoc::BaselineEntry> &baseline,
+                           const std::vector<aoc::BaselineEntry> &current, const Options &options)
+{
+    std::vector<Regression> regressions;
+    size_t compared = 0U, untested = 0U;
+    for (const auto &entry : current)
+    {
+        auto before = std::find_if(baseline.begin(), baseline.end(), [&](const aoc::BaselineEntry &other)
+                                   { return other.sameKey(entry); });
+        if (before == baseline.end() || before->samples.empty() || entry.samples.empty())
+            continue;
+        ++compared;
+
+        double beforeMedian = aoc::summarize(before->samples).median;
+        double afterMedian = aoc::summarize(entry.samples).median;
+        if (afterMedian - beforeMedian < NOISE_FLOOR_MS)
+            continue;
+
+        double changePercent = beforeMedian > 0.0 ? (afterMedian / beforeMedian - 1.0) * 100.0 : 100.0;
+        if (changePercent <= options.thresholdPercent)
+            continue;
+
+        bool testable = before->samples.size() >= MIN_TEST_SAMPLES && entry.samples.size() >= MIN_TEST_SAMPLES;
+        double pValue = aoc::mannWhitneyGreater(before->samples, entry.samples);
+        if (!testable)
+            ++untested;
+        else if (pValue >= options.alpha)
+            continue;
+
+        regressions.push_back({&*before, &entry, beforeMedian, afterMedian, changePercent, pValue});
+    }
+
+    std::sort(regressions.begin(), regressions.end(), [](const Regression &a, const Regression &b)
+              { return a.changePercent > b.changePercent; });
+
+    out << "baseline " << options.baselinePath << ": " << compared << " phases compared, "
+        << regressions.size() << " regressed (threshold " << options.thresholdPercent << "%, alpha "
+        << options.alpha << ")" << std::endl;
+    for (const auto &regression : regressions)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "day%02d part %d %s", regression.after->day, regression.after->part,
+                      regression.after->phase.c_str());
+        out << "  REGRESSION " << std::left << std::setw(22) << name << std::right << std::fixed
+            << std::setprecision(3) << regression.beforeMedian << " -> " << regression.afterMedian << " ms ("
+            << std::showpos << std::setprecision(1) << regression.changePercent << std::noshowpos << "%, p="
+            << std::setprecision(4) << regression.pValue << ")" << std::endl;
+    }
+    if (untested > 0U)
+    {
+        out << "  note: " << untested << " of these had fewer than " << MIN_TEST_SAMPLES
+            << " samples on a side and were judged by the threshold alone; use --repeat " << MIN_TEST_SAMPLES
+            << " or more" << std::endl;
+    }
+    return regressions.size();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (options.threads > 0U)
+        aoc::ThreadPool::configure(options.threads);
+    if (!options.resultsPath.empty())
+        aoc::ResultCache::configure(options.resultsPath);
+    if (options.hugePages)
+        aoc::hugepages::configure(*options.hugePages);
+    if (options.isa && aoc::cpu::forceIsa(*options.isa) != *options.isa)
+    {
+        std::cerr << "Warning: this CPU lacks " << aoc::cpu::isaName(*options.isa) << ", using "
+                  << aoc::cpu::isaName(aoc::cpu::activeIsa()) << std::endl;
+    }
+
+    if (!options.tracePath.empty() && !aoc::trace::openFile(options.tracePath))
+    {
+        std::cerr << "Error: Could not open file " << options.tracePath << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<aoc::PerfCounters> counters;
+    if (options.counters)
+    {
+        counters = std::make_unique<aoc::PerfCounters>();
+        if (!counters->anyAvailable())
+        {
+            std::cerr << "Warning: hardware counters unavailable (" << std::strerror(counters->error())
+                      << "), reporting timings only" << std::endl;
+            counters.reset();
+        }
+    }
+
+    aoc::alloc::enable(options.allocations);
+
+    std::vector<PartReport> reports;
+    std::vector<std::unique_ptr<aoc::InputFile>> files;
+    std::vector<std::unique_ptr<aoc::CacheLocation>> caches;
+    std::vector<ConcurrentJob> jobs;
+    for (int day : options.days)
+    {
+        const aoc::DayEntry *entry = aoc::findDay(day);
+        if (entry == nullptr)
+        {
+            std::cerr << "Error: no solver for day " << day << std::endl;
+            return 2;
+        }
+
+        std::string inputPath = options.inputPath.empty() ? defaultInputPath(day) : options.inputPath;
+        auto file = std::make_unique<aoc::InputFile>(inputPath);
+        if (!file->isOpen())
+        {
+            std::cerr << "Error: Could not open file " << inputPath << std::endl;
+            return 1;
+        }
+
+        std::unique_ptr<aoc::CacheLocation> cache;
+        if (options.cache && entry->cacheable() && inputPath != "-")
+            cache = prepareCache(*entry, inputPath, file->contents());
+
+        for (int part : options.parts)
+        {
+            if (options.concurrent)
+            {
+                reports.push_back(startReport(*entry, part, inputPath, file->contents()));
+                jobs.push_back({entry, part, file->contents(), cache.get(), nullptr, {}, 0});
+            }
+            else
+                reports.push_back(runPart(*entry, part, inputPath, file->contents(), options.repeat, counters.get(), cache.get()));
+        }
+        files.push_back(std::move(file));
+        caches.push_back(std::move(cache));
+    }
+
+    std::vector<double> wallMs;
+    if (options.concurrent)
+        wallMs = runConcurrent(jobs, reports, options.repeat);
+
+    // With the JSON on stdout, the text report goes to stderr
+    std::ostream &report = options.jsonPath == "-" ? std::cerr : std::cout;
+    printText(report, reports, options.repeat);
+    if (options.concurrent)
+        printConcurrent(report, reports, wallMs);
+    if (aoc::hugepages::resource().mode() != aoc::HugePageMode::OFF)
+        printHugePages(report);
+    aoc::alloc::enable(false);
+    if (counters)
+        printCounters(report, reports);
+    if (options.allocations)
+        printAllocations(report, reports);
+
+    if (options.jsonPath == "-")
+    {
+        writeJson(std::cout, reports, options.repeat, counters != nullptr, options.allocations);
+    }
+    else if (!options.jsonPath.empty())
+    {
+        std::ofstream json(options.jsonPath);
+        if (!json.is_open())
+        {
+            std::cerr << "Error: Could not open file " << options.jsonPath << std::endl;
+            return 1;
+        }
+        writeJson(json, reports, options.repeat, counters != nullptr, options.allocations);
+    }
+
+    std::vector<aoc::BaselineEntry> current = toBaseline(reports);
+    size_t regressions = 0U;
+    if (!options.baselinePath.empty())
+    {
+        std::vector<aoc::BaselineEntry> baseline;
+        if (!aoc::loadBaseline(options.baselinePath, baseline))
+            return 1;
+        regressions = compareWithBaseline(report, baseline, current, options);
+    }
+
+    if (!options.saveBaselinePath.empty())
+    {
+        std::vector<aoc::BaselineEntry> stored;
+        std::ifstream existing(options.saveBaselinePath);
+        if (existing.is_open())
+        {
+            existing.close();
+            if (!aoc::loadBaseline(options.saveBaselinePath, stored))
+                return 1;
+        }
+        aoc::mergeBaseline(stored, current);
+        if (!aoc::saveBaseline(options.saveBaselinePath, stored))
+            return 1;
+    }
+    return regressions > 0U ? EXIT_REGRESSION : 0;
+}
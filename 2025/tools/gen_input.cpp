@@ -0,0 +1,108 @@
+// gen_input: writes synthetic inputs in a day's exact format.
+//
+//   ./gen_input --day N [--size S | --scale X] [--seed SEED] [--output PATH]
+//
+// --size counts the day's natural unit (rotations, points, grid side, ...;
+// see --list). --scale X picks the size whose volume is about X times the
+// shipped input/input.txt. Output goes to stdout unless --output is given.
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "tools/generators.hpp"
+
+namespace
+{
+
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " --day N [--size S | --scale X] [--seed SEED] [--output PATH]" << std::endl;
+    std::cerr << "       " << program << " --list" << std::endl;
+}
+
+void printGenerators()
+{
+    std::cout << "day  unit        shipped size" << std::endl;
+    for (const auto &generator : aoc::gen::GENERATORS)
+    {
+        std::printf("%-4d %-11s %zu\n", generator.day, generator.unit, generator.shippedSize);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int day = 0;
+    size_t size = 0;
+    double scale = 1.0;
+    uint64_t seed = 1;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--list")
+        {
+            printGenerators();
+            return 0;
+        }
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Error: " << arg << " needs a value" << std::endl;
+            return 2;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "--day")
+            day = std::atoi(value.c_str());
+        else if (arg == "--size")
+            size = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--scale")
+            scale = std::atof(value.c_str());
+        else if (arg == "--seed")
+            seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--output")
+            outputPath = value;
+        else
+        {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    const aoc::gen::Generator *generator = aoc::gen::findGenerator(day);
+    if (generator == nullptr)
+    {
+        std::cerr << "Error: no generator for day " << day << std::endl;
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (size == 0)
+        size = aoc::gen::sizeForScale(*generator, scale);
+
+    FILE *output = outputPath.empty() ? stdout : std::fopen(outputPath.c_str(), "wb");
+    if (output == nullptr)
+    {
+        std::cerr << "Error: Could not open file " << outputPath << std::endl;
+        return 1;
+    }
+
+    {
+        aoc::gen::Writer writer(output);
+        aoc::gen::generate(*generator, size, seed, writer);
+    }
+
+    if (output != stdout)
+        std::fclose(output);
+    return 0;
+}
@@ -0,0 +1,458 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Synthetic puzzle inputs in each day's exact text format. Every generator
+// takes a size in the day's natural unit (see Generator::unit) and a seed, and
+// produces the same bytes for the same (size, seed) pair.
+
+namespace aoc::gen
+{
+
+// Collects generated text either in memory or, when given a FILE*, in 1 MB
+// chunks so inputs far larger than RAM-friendly strings can be written.
+class Writer
+{
+public:
+    Writer() = default;
+    explicit Writer(FILE *file) : file_(file) {}
+
+    ~Writer() { flush(); }
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    void put(char ch)
+    {
+        buffer_.push_back(ch);
+        maybeFlush();
+    }
+
+    void put(const char *text)
+    {
+        buffer_.append(text);
+        maybeFlush();
+    }
+
+    void put(const std::string &text)
+    {
+        buffer_.append(text);
+        maybeFlush();
+    }
+
+    void putNumber(uint64_t value)
+    {
+        char digits[24];
+        int length = std::snprintf(digits, sizeof(digits), "%llu", static_cast<unsigned long long>(value));
+        buffer_.append(digits, length);
+        maybeFlush();
+    }
+
+    void flush()
+    {
+        if (file_ && !buffer_.empty())
+        {
+            std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+            buffer_.clear();
+        }
+    }
+
+    // In-memory mode only: everything generated so far
+    const std::string &text() const { return buffer_; }
+    std::string release() { return std::move(buffer_); }
+
+private:
+    static constexpr size_t FLUSH_THRESHOLD = 1 << 20;
+
+    void maybeFlush()
+    {
+        if (file_ && buffer_.size() >= FLUSH_THRESHOLD)
+            flush();
+    }
+
+    FILE *file_ = nullptr;
+    std::string buffer_;
+};
+
+using Random = std::mt19937_64;
+
+inline uint64_t uniform(Random &random, uint64_t low, uint64_t high)
+{
+    return std::uniform_int_distribution<uint64_t>(low, high)(random);
+}
+
+inline bool chance(Random &random, double probability)
+{
+    return std::bernoulli_distribution(probability)(random);
+}
+
+inline uint64_t pow10(unsigned exponent)
+{
+    uint64_t value = 1;
+    while (exponent--)
+        value *= 10;
+    return value;
+}
+
+// day_01: one rotation per line, "L68" / "R48", magnitudes 1..999
+inline void generateDay01(size_t rotations, Random &random, Writer &out)
+{
+    for (size_t i = 0; i < rotations; ++i)
+    {
+        out.put(chance(random, 0.5) ? 'L' : 'R');
+        out.putNumber(uniform(random, 1, 999));
+        out.put('\n');
+    }
+}
+
+// day_02: one line of comma separated "first-last" ID ranges, 1..10 digit IDs,
+// spans up to ~200k IDs like the shipped input
+inline void generateDay02(size_t ranges, Random &random, Writer &out)
+{
+    for (size_t i = 0; i < ranges; ++i)
+    {
+        unsigned digits = static_cast<unsigned>(uniform(random, 1, 10));
+        uint64_t low = uniform(random, pow10(digits - 1), pow10(digits) - 1);
+        uint64_t span = uniform(random, 0, std::min<uint64_t>(200000, pow10(digits)));
+        if (i)
+            out.put(',');
+        out.putNumber(low);
+        out.put('-');
+        out.putNumber(low + span);
+    }
+    out.put('\n');
+}
+
+// day_03: one bank of 100 battery digits (1-9) per line
+inline void generateDay03(size_t banks, Random &random, Writer &out)
+{
+    std::string bank(100, '1');
+    for (size_t i = 0; i < banks; ++i)
+    {
+        for (auto &battery : bank)
+            battery = static_cast<char>('1' + uniform(random, 0, 8));
+        out.put(bank);
+        out.put('\n');
+    }
+}
+
+// day_04: square grid of '@' paper rolls and '.' floor, side x side
+inline void generateDay04(size_t side, Random &random, Writer &out)
+{
+    std::string row(side, '.');
+    for (size_t r = 0; r < side; ++r)
+    {
+        for (auto &cell : row)
+            cell = chance(random, 0.65) ? '@' : '.';
+        out.put(row);
+        out.put('\n');
+    }
+}
+
+// day_05: "first-last" fresh ID ranges (15 digit IDs, some overlapping), a
+// blank line, then ~5.4 available IDs per range, one per line
+inline void generateDay05(size_t ranges, Random &random, Writer &out)
+{
+    constexpr uint64_t ID_LIMIT = 560000000000000ULL;
+    for (size_t i = 0; i < ranges; ++i)
+    {
+        uint64_t low = uniform(random, 1, ID_LIMIT);
+        uint64_t span = uniform(random, 1000000000ULL, 6000000000000ULL);
+        out.putNumber(low);
+        out.put('-');
+        out.putNumber(low + span);
+        out.put('\n');
+    }
+    out.put('\n');
+
+    size_t ids = ranges * 1000 / 186 + 1;
+    for (size_t i = 0; i < ids; ++i)
+    {
+        out.putNumber(uniform(random, 1, ID_LIMIT));
+        out.put('\n');
+    }
+}
+
+// day_06: four rows of 1-4 digit numbers and one operator row; every problem
+// is a column block as wide as its widest number, blocks separated by a space
+// and numbers randomly left or right aligned inside their block
+inline void generateDay06(size_t problems, Random &random, Writer &out)
+{
+    constexpr size_t NUMBER_ROWS = 4;
+    std::vector<std::string> rows(NUMBER_ROWS + 1);
+
+    for (size_t p = 0; p < problems; ++p)
+    {
+        std::string numbers[NUMBER_ROWS];
+        size_t width = 0;
+        for (auto &number : numbers)
+        {
+            unsigned digits = static_cast<unsigned>(uniform(random, 1, 4));
+            number = std::to_string(uniform(random, pow10(digits - 1), pow10(digits) - 1));
+            width = std::max(width, number.size());
+        }
+
+        bool rightAligned = chance(random, 0.5);
+        for (size_t r = 0; r < NUMBER_ROWS; ++r)
+        {
+            std::string padding(width - numbers[r].size(), ' ');
+            rows[r] += rightAligned ? padding + numbers[r] : numbers[r] + padding;
+        }
+        rows[NUMBER_ROWS] += chance(random, 0.5) ? '+' : '*';
+        rows[NUMBER_ROWS] += std::string(width - 1, ' ');
+
+        if (p + 1 < problems)
+        {
+            for (auto &row : rows)
+                row += ' ';
+        }
+    }
+
+    for (const auto &row : rows)
+    {
+        out.put(row);
+        out.put('\n');
+    }
+}
+
+// day_07: manifold side rows tall, 'S' centred on the first row and '^'
+// splitters on every other row inside the triangle the beams can reach. Half
+// the diagrams are narrower than side, so the triangle runs into the edge
+// columns and splitters there send beams off the grid.
+inline void generateDay07(size_t side, Random &random, Writer &out)
+{
+    side = std::max<size_t>(side, 3) | 1U; // odd, so 'S' sits in the middle
+    size_t width = chance(random, 0.5) ? std::min<size_t>(uniform(random, 3, side) | 1U, side) : side;
+    auto start = static_cast<ptrdiff_t>(width / 2);
+    auto last = static_cast<ptrdiff_t>(width) - 1;
+    std::string row(width, '.');
+
+    row[start] = 'S';
+    out.put(row);
+    out.put('\n');
+
+    for (size_t r = 1; r < side; ++r)
+    {
+        std::fill(row.begin(), row.end(), '.');
+        auto depth = static_cast<ptrdiff_t>(r / 2);
+        if (r % 2 == 0)
+        {
+            // Positions past an edge keep the triangle's parity
+            ptrdiff_t first = start - depth;
+            if (first < 0)
+                first += (1 - first) / 2 * 2;
+            for (ptrdiff_t c = first; c <= std::min(start + depth, last); c += 2)
+            {
+                if (depth == 1 || chance(random, 0.7))
+                    row[c] = '^';
+            }
+        }
+        out.put(row);
+        out.put('\n');
+    }
+}
+
+// day_08: "x,y,z" junction box coordinates in [0, 100000)
+inline void generateDay08(size_t points, Random &random, Writer &out)
+{
+    for (size_t i = 0; i < points; ++i)
+    {
+        out.putNumber(uniform(random, 0, 99999));
+        out.put(',');
+        out.putNumber(uniform(random, 0, 99999));
+        out.put(',');
+        out.putNumber(uniform(random, 0, 99999));
+        out.put('\n');
+    }
+}
+
+// day_09: "x,y" vertices of a simple rectilinear polygon, in boundary order.
+// The polygon is x-monotone: columns between increasing x stops get a random
+// top above the mid line and a random bottom below it, giving 4 vertices per
+// column and alternating horizontal/vertical edges.
+inline void generateDay09(size_t vertices, Random &random, Writer &out)
+{
+    constexpr uint64_t EXTENT = 100000;
+    size_t columns = std::max<size_t>(vertices / 4, 1);
+
+    std::vector<uint64_t> xs;
+    uint64_t step = std::max<uint64_t>(EXTENT / (columns + 1), 2);
+    uint64_t x = uniform(random, 1, step);
+    for (size_t i = 0; i <= columns; ++i)
+    {
+        xs.push_back(x);
+        x += uniform(random, 1, step);
+    }
+
+    auto pickDifferent = [&](uint64_t previous, uint64_t low, uint64_t high)
+    {
+        uint64_t value;
+        do
+        {
+            value = uniform(random, low, high);
+        } while (value == previous);
+        return value;
+    };
+
+    std::vector<uint64_t> tops(columns), bottoms(columns);
+    for (size_t i = 0; i < columns; ++i)
+    {
+        tops[i] = pickDifferent(i ? tops[i - 1] : 0, EXTENT / 2 + 1, EXTENT);
+        bottoms[i] = pickDifferent(i ? bottoms[i - 1] : EXTENT, 1, EXTENT / 2 - 1);
+    }
+
+    auto vertex = [&](uint64_t vx, uint64_t vy)
+    {
+        out.putNumber(vx);
+        out.put(',');
+        out.putNumber(vy);
+        out.put('\n');
+    };
+
+    vertex(xs[0], tops[0]);
+    for (size_t i = 1; i < columns; ++i)
+    {
+        vertex(xs[i], tops[i - 1]);
+        vertex(xs[i], tops[i]);
+    }
+    vertex(xs[columns], tops[columns - 1]);
+    vertex(xs[columns], bottoms[columns - 1]);
+    for (size_t i = columns - 1; i >= 1; --i)
+    {
+        vertex(xs[i], bottoms[i]);
+        vertex(xs[i], bottoms[i - 1]);
+    }
+    vertex(xs[0], bottoms[0]);
+}
+
+// day_10: one machine per line, "[.##.] (3) (1,3) ... {3,5,4,7}". Light
+// targets are the XOR of a random subset of buttons and joltage targets the
+// sum of random press counts, so both parts always have a solution.
+inline void generateDay10(size_t machines, Random &random, Writer &out)
+{
+    for (size_t m = 0; m < machines; ++m)
+    {
+        size_t lights = uniform(random, 4, 10);
+        size_t buttons = uniform(random, 2, 13);
+
+        std::vector<uint32_t> masks(buttons);
+        uint32_t covered = 0;
+        for (auto &mask : masks)
+        {
+            while (mask == 0)
+            {
+                for (size_t l = 0; l < lights; ++l)
+                    if (chance(random, 0.4))
+                        mask |= 1U << l;
+            }
+            covered |= mask;
+        }
+        // Every light needs at least one button or the joltage target is unreachable
+        for (size_t l = 0; l < lights; ++l)
+            if (!(covered & (1U << l)))
+                masks[uniform(random, 0, buttons - 1)] |= 1U << l;
+
+        uint32_t desiredState = 0;
+        std::vector<uint64_t> joltage(lights, 0);
+        for (auto mask : masks)
+        {
+            if (chance(random, 0.5))
+                desiredState ^= mask;
+            uint64_t presses = uniform(random, 0, 20);
+            for (size_t l = 0; l < lights; ++l)
+                if (mask & (1U << l))
+                    joltage[l] += presses;
+        }
+
+        out.put('[');
+        for (size_t l = 0; l < lights; ++l)
+            out.put((desiredState & (1U << l)) ? '#' : '.');
+        out.put(']');
+
+        for (auto mask : masks)
+        {
+            out.put(" (");
+            bool first = true;
+            for (size_t l = 0; l < lights; ++l)
+            {
+                if (!(mask & (1U << l)))
+                    continue;
+                if (!first)
+                    out.put(',');
+                out.putNumber(l);
+                first = false;
+            }
+            out.put(')');
+        }
+
+        out.put(" {");
+        for (size_t l = 0; l < lights; ++l)
+        {
+            if (l)
+                out.put(',');
+            out.putNumber(joltage[l]);
+        }
+        out.put("}\n");
+    }
+}
+
+struct Generator
+{
+    int day;
+    const char *unit;      // what the size parameter counts
+    size_t shippedSize;    // size of the shipped input/input.txt in that unit
+    bool squareGrid;       // size is a side length, so volume grows with size^2
+    void (*generate)(size_t size, Random &random, Writer &out);
+};
+
+inline constexpr Generator GENERATORS[] = {
+    {1, "rotations", 4541, false, generateDay01},
+    {2, "ranges", 29, false, generateDay02},
+    {3, "banks", 199, false, generateDay03},
+    {4, "grid side", 135, true, generateDay04},
+    {5, "ranges", 186, false, generateDay05},
+    {6, "problems", 1000, false, generateDay06},
+    {7, "grid side", 141, true, generateDay07},
+    {8, "points", 999, false, generateDay08},
+    {9, "vertices", 496, false, generateDay09},
+    {10, "machines", 173, false, generateDay10},
+};
+
+inline const Generator *findGenerator(int day)
+{
+    for (const auto &generator : GENERATORS)
+    {
+        if (generator.day == day)
+            return &generator;
+    }
+    return nullptr;
+}
+
+// Size whose input volume is roughly `scale` times the shipped input
+inline size_t sizeForScale(const Generator &generator, double scale)
+{
+    double factor = generator.squareGrid ? std::sqrt(scale) : scale;
+    return std::max<size_t>(1, static_cast<size_t>(std::llround(generator.shippedSize * factor)));
+}
+
+inline void generate(const Generator &generator, size_t size, uint64_t seed, Writer &out)
+{
+    Random random(seed ^ (static_cast<uint64_t>(generator.day) << 56));
+    generator.generate(size, random, out);
+}
+
+inline std::string generateText(const Generator &generator, size_t size, uint64_t seed)
+{
+    Writer out;
+    generate(generator, size, seed, out);
+    return out.release();
+}
+
+} // namespace aoc::gen